@@ -0,0 +1,217 @@
+/**
+ * 대표적인 파이프라인 형태별 종단 간 벤치마크입니다.
+ *
+ *  chain     : 긴 직렬 체인
+ *  diamond   : 넓은 fan-out 후 fan-in
+ *  optional  : 주 경로 옆에 무거운 optional 분기가 매달린 형태. optional 분기는 바쁘면 fence를 건너뜁니다.
+ *  selective : 비용이 다른 분기들을 선택적 입력으로 합류
+ *  tree      : tests/gui/sample_pipeline.cpp에 주석 처리된 깊은 트리
+ *
+ * 각 형태는 측정 기준이 되는 sink 파이프를 가지며, sink의 출력 시점을 기준으로 처리량과 p50/p99 지연, CPU 사용률을 출력합니다.
+ *
+ * usage: pipepp_bench_dag [num_fences=2000] [exec_cost_us=50] [num_executors=4]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "fmt/format.h"
+#include "pipepp/pipepp.h"
+
+namespace pipepp_bench {
+using namespace pipepp;
+using namespace std::chrono;
+
+struct shared_data : base_shared_context {
+};
+
+/** 지정된 시간 동안 CPU를 점유하는 실행기. 비용은 cost_multiplier 배로 조절됩니다. */
+struct exec_busy {
+    inline static microseconds base_cost{50};
+
+    using input_type = int;
+    using output_type = int;
+
+    explicit exec_busy(int cost_multiplier = 1)
+        : cost_(base_cost * cost_multiplier)
+    {
+    }
+
+    pipe_error invoke(execution_context&, input_type const& i, output_type& o)
+    {
+        auto until = steady_clock::now() + cost_;
+        while (steady_clock::now() < until) {}
+        o = i;
+        return pipe_error::ok;
+    }
+
+private:
+    microseconds cost_;
+};
+
+using pipeline_type = pipeline<shared_data, exec_busy>;
+using proxy_type = pipeline_type::initial_proxy_type;
+
+struct config {
+    size_t num_fences = 2000;
+    size_t num_executors = 4;
+};
+
+/** 프로세스 전체의 누적 CPU 시간 */
+nanoseconds process_cpu_time()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto to_ns = [](FILETIME ft) { return (uint64_t(ft.dwHighDateTime) << 32 | ft.dwLowDateTime) * 100; };
+    return nanoseconds(to_ns(kernel) + to_ns(user));
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    auto to_ns = [](timeval tv) { return int64_t(tv.tv_sec) * 1'000'000'000 + int64_t(tv.tv_usec) * 1000; };
+    return nanoseconds(to_ns(usage.ru_utime) + to_ns(usage.ru_stime));
+#endif
+}
+
+/** 실행 비용 배율을 받는 실행기 팩토리 */
+auto busy_factory(int cost_multiplier) { return make_executor<exec_busy>(cost_multiplier); }
+
+/** 형태 빌더는 첫 파이프를 받아 sink 파이프를 반환합니다. */
+using shape_builder = std::function<proxy_type(config const&, pipeline_type&, proxy_type)>;
+
+void run_shape(std::string const& name, config const& cfg, shape_builder const& build)
+{
+    auto pl = pipeline_type::make("src", cfg.num_executors, &busy_factory, 1);
+    auto sink = build(cfg, *pl, pl->front());
+
+    std::mutex latency_lock;
+    std::vector<double> latencies_us;
+    latencies_us.reserve(cfg.num_fences);
+
+    sink.add_output_handler([&](shared_data const& sd, int const&) {
+        auto latency = duration<double, std::micro>(pipepp::instrument_clock::now() - sd.launch_time_point()).count();
+        std::lock_guard lock{latency_lock};
+        latencies_us.push_back(latency);
+    });
+    pl->launch();
+
+    auto const cpu_begin = process_cpu_time();
+    auto const wall_begin = steady_clock::now();
+
+    for (size_t i = 0; i < cfg.num_fences; ++i) {
+        while (!pl->suply(static_cast<int>(i), [](auto&&) {})) { pl->wait_supliable(); }
+    }
+    pl->sync();
+
+    auto const wall = duration<double>(steady_clock::now() - wall_begin).count();
+    auto const cpu = duration<double>(process_cpu_time() - cpu_begin).count();
+    auto const num_cores = std::max(1u, std::thread::hardware_concurrency());
+
+    std::ranges::sort(latencies_us);
+    auto percentile = [&](double p) {
+        return latencies_us.empty() ? 0. : latencies_us[std::min(latencies_us.size() - 1, size_t(p * latencies_us.size()))];
+    };
+
+    fmt::print("{:<10} | {:>10.1f} fence/s | p50 {:>9.1f} us | p99 {:>9.1f} us | cpu {:>5.1f}% | dropped {}\n",
+               name, latencies_us.size() / wall,
+               percentile(0.5), percentile(0.99), 100. * cpu / (wall * num_cores),
+               cfg.num_fences - latencies_us.size());
+}
+
+proxy_type link_busy(proxy_type from, std::string name, config const& cfg, int cost_multiplier = 1)
+{
+    return from.create_and_link_output(std::move(name), cfg.num_executors, link_as_is, &busy_factory, cost_multiplier);
+}
+
+proxy_type build_chain(config const& cfg, pipeline_type&, proxy_type src)
+{
+    constexpr int DEPTH = 16;
+    auto tail = src;
+    for (int i = 1; i < DEPTH; ++i) { tail = link_busy(tail, fmt::format("chain.{}", i), cfg); }
+    return tail;
+}
+
+proxy_type build_diamond(config const& cfg, pipeline_type& pl, proxy_type src)
+{
+    constexpr int WIDTH = 8;
+    auto join = pl.create("join", cfg.num_executors, &busy_factory, 1);
+    for (int i = 0; i < WIDTH; ++i) { link_busy(src, fmt::format("fan.{}", i), cfg).link_output(join, link_as_is); }
+    return join;
+}
+
+proxy_type build_optional(config const& cfg, pipeline_type&, proxy_type src)
+{
+    // optional 노드의 출력은 가장 가까운 optional 노드가 다른 경로와 합류할 수 없으므로, 분기 내부에서 끝납니다.
+    auto heavy = link_busy(src, "heavy.optional", cfg, 4);
+    heavy.configure_tweaks().is_optional = true;
+    link_busy(heavy, "heavy.post", cfg);
+
+    return link_busy(link_busy(src, "main", cfg), "sink", cfg);
+}
+
+proxy_type build_selective(config const& cfg, pipeline_type& pl, proxy_type src)
+{
+    constexpr int WIDTH = 4;
+    auto join = pl.create("join", cfg.num_executors, &busy_factory, 1);
+    for (int i = 0; i < WIDTH; ++i) { link_busy(src, fmt::format("branch.{}", i), cfg, i + 1).link_output(join, link_as_is); }
+    join.configure_tweaks().selective_input = true;
+    return join;
+}
+
+proxy_type build_tree(config const& cfg, pipeline_type&, proxy_type _0)
+{
+    // tests/gui/sample_pipeline.cpp에 주석 처리된 그래프입니다.
+    auto pew = [&](proxy_type from, char const* name) { return link_busy(from, name, cfg); };
+    auto _1 = pew(_0, "_1"), _2 = pew(_0, "_2"), _3 = pew(_0, "_3");
+    auto _11 = pew(_2, "_11"), _12 = pew(_2, "_12"), _13 = pew(_2, "_13");
+    auto _14 = pew(_11, "_14"), _15 = pew(_11, "_15"), _16 = pew(_11, "_16"), _17 = pew(_11, "_17");
+    auto _18 = pew(_12, "_18"), _19 = pew(_12, "_19");
+    _11.link_output(_18, link_as_is);
+    _11.link_output(_19, link_as_is);
+    _13.link_output(_17, link_as_is);
+    _13.link_output(_18, link_as_is);
+    _13.link_output(_19, link_as_is);
+    _19.configure_tweaks().selective_input = true;
+    auto _20 = pew(_12, "_20"), _21 = pew(_13, "_21"), _22 = pew(_13, "_22"), _23 = pew(_13, "_23");
+    auto _4 = pew(_1, "_4"), _5 = pew(_1, "_5"), _6 = pew(_4, "_6"), _7 = pew(_6, "_7");
+    _5.link_output(_7, link_as_is);
+    _7.configure_tweaks().selective_input = true;
+    auto _8 = pew(_7, "_8"), _9 = pew(_8, "_9");
+    _19.link_output(_20, link_as_is);
+    _19.link_output(_21, link_as_is);
+    _19.link_output(_22, link_as_is);
+    _21.link_output(_23, link_as_is);
+
+    // 가장 깊은 경로의 말단을 기준으로 지연을 측정합니다.
+    return _9;
+}
+} // namespace pipepp_bench
+
+int main(int argc, char** argv)
+{
+    using namespace pipepp_bench;
+    config cfg;
+    if (argc > 1) { cfg.num_fences = std::stoul(argv[1]); }
+    if (argc > 2) { exec_busy::base_cost = microseconds(std::stoul(argv[2])); }
+    if (argc > 3) { cfg.num_executors = std::stoul(argv[3]); }
+
+    fmt::print("fences: {}, executor cost: {} us, executors per pipe: {}\n",
+               cfg.num_fences, exec_busy::base_cost.count(), cfg.num_executors);
+
+    run_shape("chain", cfg, &build_chain);
+    run_shape("diamond", cfg, &build_diamond);
+    run_shape("optional", cfg, &build_optional);
+    run_shape("selective", cfg, &build_selective);
+    run_shape("tree", cfg, &build_tree);
+}
@@ -0,0 +1,238 @@
+/**
+ * 프레임워크 자체의 오버헤드를 측정하는 마이크로벤치마크입니다.
+ * 모든 실행기는 입력을 그대로 출력하는 빈 실행기이며, 결과는 fence당 ns 단위로 출력합니다.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#include "fmt/format.h"
+#include "pipepp/critical_path.hpp"
+#include "pipepp/pipepp.h"
+
+namespace pipepp_bench {
+using namespace pipepp;
+using bench_clock = std::chrono::steady_clock;
+
+struct shared_data : base_shared_context {
+};
+
+struct exec_empty {
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context&, input_type const& i, output_type& o)
+    {
+        o = i;
+        return pipe_error::ok;
+    }
+};
+
+/** 파이프라인 내부 함수에 직접 접근하기 위한 최소 파이프라인 */
+class bench_pipeline final : public detail::pipeline_base {
+public:
+    bench_pipeline() { pipes_.emplace_back(std::make_unique<detail::pipe_base>("bench.front")); }
+    using pipeline_base::_fetch_shared;
+
+protected:
+    std::shared_ptr<base_shared_context> _new_shared_object() override { return std::make_shared<shared_data>(); }
+    bool _copy_shared_object(base_shared_context&, base_shared_context const&) override { return false; }
+};
+
+/** 파이프 프록시에서 파이프 본체에 접근하기 위한 래퍼 */
+struct pipe_access : detail::pipe_proxy_base {
+    explicit pipe_access(detail::pipe_proxy_base const& proxy)
+        : pipe_proxy_base(proxy)
+    {
+    }
+    using pipe_proxy_base::pipe;
+};
+
+template <typename Fn_>
+double measure_ns(size_t iterations, Fn_&& fn)
+{
+    for (size_t i = 0; i < iterations / 10; ++i) { fn(i); } // warm-up
+
+    auto begin = bench_clock::now();
+    for (size_t i = 0; i < iterations; ++i) { fn(i); }
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count() / iterations;
+}
+
+void report(std::string_view name, double ns_per_fence)
+{
+    fmt::print("{:<48} {:>12.1f} ns/fence\n", name, ns_per_fence);
+}
+
+/** 빈 실행기로 구성된 num_hops 단계 체인에서, 순차 공급 시 fence 하나가 끝까지 도달하는 데 걸리는 시간 */
+double sequential_fence_latency(size_t num_hops, size_t num_handlers, size_t iterations)
+{
+    using pipeline_type = pipeline<shared_data, exec_empty>;
+    auto pl = pipeline_type::make("hop.0", 1, &make_executor<exec_empty>);
+    std::atomic_size_t num_done = 0;
+
+    auto tail = pl->front();
+    for (size_t hop = 1; hop < num_hops; ++hop) {
+        tail = tail.create_and_link_output(fmt::format("hop.{}", hop), 1, link_as_is, &make_executor<exec_empty>);
+    }
+    for (size_t i = 0; i < num_handlers; ++i) {
+        tail.add_output_handler([](shared_data const&, int const&) {});
+    }
+    tail.add_output_handler([&](shared_data const&, int const&) { num_done.fetch_add(1, std::memory_order_release); });
+    pl->launch();
+
+    auto result = measure_ns(iterations, [&](size_t i) {
+        auto expected = num_done.load() + 1;
+        while (!pl->suply(static_cast<int>(i), [](auto&&) {})) { std::this_thread::yield(); }
+        while (num_done.load(std::memory_order_acquire) < expected) { std::this_thread::yield(); }
+    });
+
+    pl->sync();
+    return result;
+}
+
+void bench_execution_context(size_t iterations)
+{
+    detail::option_base options;
+    execution_context ec;
+    ec._internal__set_option(&options);
+
+    report("execution_context timer scope x2", measure_ns(iterations, [&](size_t) {
+               ec._clear_records();
+               {
+                   auto total = ec.timer_scope("Total Execution Time");
+                   auto inner = ec.timer_scope("Inner");
+               }
+               ec._swap_data_buff();
+           }));
+
+    report("execution_context debug data x2", measure_ns(iterations, [&](size_t i) {
+               ec._clear_records();
+               {
+                   auto total = ec.timer_scope("Total Execution Time");
+                   ec.store_debug_data("Integer", i);
+                   ec.store_debug_data("Real", i * 0.5);
+               }
+               ec._swap_data_buff();
+           }));
+}
+
+void bench_fetch_shared(size_t iterations)
+{
+    auto pl = std::make_shared<bench_pipeline>();
+    report("pipeline_base::_fetch_shared", measure_ns(iterations, [&](size_t) {
+               auto shared = pl->_fetch_shared();
+           }));
+}
+
+void bench_linker_dispatch(size_t iterations)
+{
+    detail::pipe_base prev{"bench.prev"}, next{"bench.next"};
+    prev.connect_output_to<shared_data, int, int>(next, link_as_is);
+
+    shared_data shared;
+    execution_context ec;
+    std::any output = 1, input;
+    auto& handler = prev.output_links().front().handler;
+
+    report("linker dispatch (connect_output_to)", measure_ns(iterations, [&](size_t) {
+               handler(shared, ec, output, input, next.options());
+           }));
+}
+
+/**
+ * 상류 파이프의 실행 없이 input_slot_t::_submit_input()을 직접 호출해, 입력 하나가 실행기 슬롯에 할당되기까지의 비용을 측정합니다.
+ * 입력이 모두 채워지면 _submit_input() 안에서 _launch_async()까지 호출되며, 그 이후의 실행은 측정 구간에서 제외합니다.
+ */
+void bench_submit_input(size_t iterations)
+{
+    using pipeline_type = pipeline<shared_data, exec_empty>;
+    auto pl = pipeline_type::make("bench.front", 1, &make_executor<exec_empty>);
+    auto sink_proxy = pl->front().create_and_link_output("bench.sink", 1, link_as_is, &make_executor<exec_empty>);
+    pl->launch();
+
+    auto& front = pipe_access{pl->front()}.pipe();
+    auto& sink = pipe_access{sink_proxy}.pipe();
+    auto& slot = sink._input_slot();
+    auto const fence_obj = std::make_shared<shared_data>();
+
+    bench_clock::duration elapsed = {};
+    auto submit = [&](size_t i) {
+        std::function<bool(std::any&)> input_manip = [i](std::any& input) { return input = static_cast<int>(i), true; };
+
+        auto begin = bench_clock::now();
+        slot._submit_input(slot.active_input_fence(), front.id(), input_manip, fence_obj);
+        elapsed += bench_clock::now() - begin;
+
+        while (!sink.wait_active_slot_idle(std::chrono::milliseconds{1})) {}
+    };
+
+    for (size_t i = 0; i < iterations / 10; ++i) { submit(i); } // warm-up
+    elapsed = {};
+    for (size_t i = 0; i < iterations; ++i) { submit(i); }
+    pl->sync();
+
+    report("input_slot_t::_submit_input (incl. _launch_async)", std::chrono::duration<double, std::nano>(elapsed).count() / iterations);
+}
+
+/**
+ * 임계 경로 분석기의 fence 시각 기록으로, _launch_async()가 작업을 등록한 뒤 작업자 스레드에서 _launch_callback()이 시작되기까지의 시간을 측정합니다.
+ * 단일 파이프 파이프라인에서는 모든 fence의 임계 경로가 해당 파이프를 지나므로, 실행 대기열 구간의 누적 시간이 곧 전체 fence의 합입니다.
+ */
+void bench_launch_dispatch(size_t iterations)
+{
+    using pipeline_type = pipeline<shared_data, exec_empty>;
+    auto pl = pipeline_type::make("bench.single", 1, &make_executor<exec_empty>);
+    auto analyzer = std::make_shared<critical_path_analyzer>();
+    pl->set_critical_path_analyzer(analyzer);
+    pl->launch();
+
+    auto run = [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            while (!pl->suply(static_cast<int>(i), [](auto&&) {})) { std::this_thread::yield(); }
+        }
+        pl->sync();
+    };
+
+    run(iterations / 10); // warm-up
+    analyzer->reset();
+    run(iterations);
+
+    double queue_ns = 0;
+    for (auto& entry : analyzer->report()) {
+        if (entry.segment == critical_path_analyzer::segment_t::queue) { queue_ns = std::chrono::duration<double, std::nano>(entry.total).count(); }
+    }
+    report("_launch_async -> _launch_callback", queue_ns / std::max<size_t>(analyzer->num_fences(), 1));
+}
+
+void bench_pipeline_dispatch(size_t iterations)
+{
+    constexpr size_t NUM_HOPS = 9;
+    constexpr size_t NUM_HANDLERS = 256;
+
+    auto single = sequential_fence_latency(1, 0, iterations);
+    auto chain = sequential_fence_latency(NUM_HOPS, 0, iterations);
+    auto handlers = sequential_fence_latency(1, NUM_HANDLERS, iterations);
+
+    report("single-pipe round trip (suply -> executor -> output handler)", single);
+    report("per hop (_submit_input + launch + link)", (chain - single) / (NUM_HOPS - 1));
+    report("per output handler dispatch", (handlers - single) / NUM_HANDLERS);
+}
+} // namespace pipepp_bench
+
+int main(int argc, char** argv)
+{
+    using namespace pipepp_bench;
+    size_t const iterations = argc > 1 ? std::stoul(argv[1]) : 100'000;
+    size_t const fence_iterations = iterations / 10;
+
+    bench_execution_context(iterations);
+    bench_fetch_shared(iterations);
+    bench_linker_dispatch(iterations);
+    bench_submit_input(fence_iterations);
+    bench_launch_dispatch(fence_iterations);
+    bench_pipeline_dispatch(fence_iterations);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pipepp/pipe.hpp"
+
+namespace pipepp {
+/**
+ * fence마다 종단 간 지연을 결정한 임계 경로를 계산하고, 여러 fence에 걸쳐 집계합니다.
+ *
+ * 임계 경로는 출력 파이프가 없는 파이프 중 가장 늦게 끝난 파이프에서 시작해, 입력 파이프 중 출력 순서 대기를 가장 늦게 마친 파이프를 따라 거슬러 올라갑니다.
+ * 경로 위의 각 파이프는 입력 대기, 실행 대기열, 실행, 출력 순서 대기, 링크 대기 구간으로 나뉘며,
+ * fence마다 가장 긴 구간이 그 fence의 지연을 결정한 것으로 집계됩니다.
+ *
+ * pipeline_base::set_critical_path_analyzer()로 시동 전에 연결합니다. 완료된 fence는 shared context가 재사용될 때, 또는 sync() 호출 시 수집됩니다.
+ */
+class critical_path_analyzer {
+public:
+    enum class segment_t : uint8_t {
+        input_wait,  // 상류 파이프의 출력 후 입력이 실행기 슬롯에 할당될 때까지
+        queue,       // 작업자 스레드가 실행을 시작할 때까지
+        run,         // 실행기 실행
+        output_wait, // 출력 순서 대기 ("B. Await for output order")
+        link_wait,   // 하류 파이프에 입력을 전달하기까지의 대기
+        _count
+    };
+
+    static std::string_view segment_name(segment_t segment);
+
+    struct entry_type {
+        std::string pipe;
+        segment_t segment;
+        size_t num_bounding;            // 이 구간이 fence의 임계 경로에서 가장 길었던 횟수
+        std::chrono::nanoseconds total; // 임계 경로 위에서 누적된 시간
+    };
+
+public:
+    size_t num_fences() const;
+
+    /** 주어진 파이프가 임계 경로에 포함된 fence 개수 */
+    size_t num_on_path(std::string_view pipe) const;
+
+    /** 임계 경로에 한 번이라도 나타난 모든 구간을 지연을 결정한 횟수, 누적 시간 순으로 정렬해 반환합니다. */
+    std::vector<entry_type> report() const;
+
+    void reset();
+
+public:
+    void _set_topology(std::vector<std::string> names, std::vector<std::vector<size_t>> inputs);
+    void _add(base_shared_context const& fence);
+
+private:
+    struct segment_stat {
+        size_t num_bounding = 0;
+        std::chrono::nanoseconds total = {};
+    };
+
+    struct pipe_stat {
+        size_t num_on_path = 0;
+        std::array<segment_stat, static_cast<size_t>(segment_t::_count)> segments = {};
+    };
+
+    mutable std::mutex lock_;
+    std::vector<std::string> names_;
+    std::vector<std::vector<size_t>> inputs_;
+    std::vector<bool> is_sink_;
+    std::vector<pipe_stat> stats_;
+    size_t num_fences_ = 0;
+};
+
+} // namespace pipepp
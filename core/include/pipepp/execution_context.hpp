@@ -1,23 +1,52 @@
 #pragma once
+#include <algorithm>
 #include <any>
 #include <array>
 #include <chrono>
+#include <concepts>
+#include <memory>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <variant>
+#include <vector>
 
 #include "kangsw/helpers/hash_index.hxx"
 #include "kangsw/helpers/misc.hxx"
 #include "kangsw/thread/spinlock.hxx"
+#include "pipepp/instrument_clock.hpp"
 
 namespace pipepp {
 namespace detail {
 class option_base;
+class option_snapshot;
 } // namespace detail
 
+/** 전역 이름 테이블에 등록된 이름. name은 프로그램이 종료될 때까지 유효합니다. */
+struct interned_name {
+    kangsw::hash_index hash;
+    std::string_view name;
+};
+
 /**
- * 전역 string table을 얻어옵니다. 모든 execution_context는 이 함수를 사용.
+ * 이름을 전역 이름 테이블에 등록합니다. 같은 해시의 이름이 이미 있다면 그 이름을 반환합니다.
+ * 테이블은 삽입만 가능한 lock-free 해시 테이블로, 조회와 등록 모두 잠금을 잡지 않습니다.
+ * 리터럴 이름은 계측 매크로가 detail::static_interned_name으로 정적 초기화 시점에 등록합니다.
  */
-kangsw::safe_string_table& string_pool();
+interned_name intern_name(kangsw::hash_pack hp);
+
+namespace detail {
+/** 템플릿 인자로 전달하기 위한 문자열 리터럴 */
+template <size_t N_>
+struct literal_name {
+    constexpr literal_name(char const (&str)[N_]) { std::copy_n(str, N_, value); }
+    char value[N_];
+};
+
+/** 리터럴 이름마다 하나씩 인스턴스화되며, 정적 초기화 시점에 전역 이름 테이블에 등록됩니다. */
+template <literal_name Name_>
+inline interned_name const static_interned_name = intern_name(Name_.value);
+} // namespace detail
 
 /**
  * 실행 문맥 데이터 형식
@@ -28,7 +57,7 @@ kangsw::safe_string_table& string_pool();
  * 를 저장하고 있습니다.
  */
 struct execution_context_data {
-    using clock = std::chrono::system_clock;
+    using clock = instrument_clock;
     using debug_variant = std::variant<bool, int64_t, double, std::string, std::any>;
     friend class execution_context;
 
@@ -39,6 +68,8 @@ public:
         kangsw::hash_index category_id;
         size_t category_level;
         clock::duration elapsed;
+        clock::time_point issued;
+        std::thread::id thread;
     };
 
     struct debug_data_entity {
@@ -65,13 +96,15 @@ public:
  *
  * 등의 기능을 제공합니다.
  *
- * 내부에 두 개의 데이터 버퍼를 갖고 있으며, 기본적으로 clear_records가 호출될 때마다 두 개의 버퍼를 스왑합니다.
- * 이를 통해 메모리 재할당을 방지할 수 있는데, 만약 외부에서 context를 요청한 경우 백 버퍼의 오브젝트를 넘기고 재생성합니다.
+ * 내부에 세 개의 데이터 버퍼(쓰기, 대기, 읽기)를 갖고 있으며, 실행기는 쓰기 버퍼를 대기 버퍼와 원자적으로 교환해 결과를 게시합니다.
+ * 읽는 쪽은 대기 버퍼를 읽기 버퍼와 교환해 가져가므로, 두 쪽 모두 잠금이나 메모리 할당 없이 서로 다른 버퍼만 접근합니다.
+ * 단, 이전에 가져간 읽기 버퍼를 외부에서 아직 참조하고 있다면 덮어쓸 수 없으므로, 그 경우에만 새 버퍼를 할당합니다.
  */
 class execution_context {
 public:
     template <typename Ty_> using lock_type = std::unique_lock<Ty_>;
-    using clock = std::chrono::system_clock;
+    using clock = instrument_clock;
+    using debug_filter_type = std::unordered_set<kangsw::hash_index>;
 
     // TODO: 디버그 플래그 제어
     // TODO: 디버그 데이터 저장(variant<bool, long, double, string, any> [])
@@ -86,7 +119,7 @@ public:
 
     private:
         friend class execution_context;
-        execution_context* self_;
+        execution_context* self_ = nullptr; // 기록하지 않는 범위라면 nullptr
         size_t index_ = {};
         clock::time_point issue_;
         kangsw::ownership owning_;
@@ -106,19 +139,41 @@ public: // methods
      * @brief 입력을 추출 가능한 상태인지 확인합니다.
      * @return 현재 입력을 추출 가능하면 true
      */
-    bool can_consume_read_buffer() const { return rd_buf_valid_.test(std::memory_order_relaxed); }
+    bool can_consume_read_buffer() const { return pending_.load(std::memory_order_relaxed) & pending_fresh_bit; }
+
+    /**
+     * 이번 실행의 타이머와 디버그 데이터를 기록하는지 확인합니다.
+     * 샘플링 간격 밖의 fence에서는 false이며, 계측 매크로는 인자를 평가하기 전에 이를 검사합니다.
+     */
+    bool is_recording() const { return recording_; }
 
     /**
      * 현재 범위에 유효한 타이머를 생성합니다.
      * 카테고리를 하나 증가시킵니다. 
      */
-    timer_scope_indicator timer_scope(kangsw::hash_pack name);
+    timer_scope_indicator timer_scope(kangsw::hash_pack name) { return timer_scope(intern_name(name)); }
+    timer_scope_indicator timer_scope(interned_name name);
 
     /**
      * 디버그 변수를 새롭게 저장합니다.
+     * 구독하지 않은 키라면 값은 저장하지 않고, 빈 std::any로 이름만 기록합니다.
      */
     template <typename Ty_>
-    void store_debug_data(kangsw::hash_pack, Ty_&& value);
+    void store_debug_data(interned_name, Ty_&& value);
+    template <typename Ty_>
+    void store_debug_data(kangsw::hash_pack hp, Ty_&& value) { store_debug_data(intern_name(hp), std::forward<Ty_>(value)); }
+
+    /**
+     * 디버그 변수를 지연 생성해 저장합니다.
+     * make_value는 기록 중이며 구독된 키일 때만 호출되므로, 이미지 등 생성 비용이 큰 값에 사용합니다.
+     */
+    template <typename Fn_> requires std::invocable<Fn_&>
+    void store_debug_data(interned_name, Fn_&& make_value);
+    template <typename Fn_> requires std::invocable<Fn_&>
+    void store_debug_data(kangsw::hash_pack hp, Fn_&& make_value) { store_debug_data(intern_name(hp), std::forward<Fn_>(make_value)); }
+
+    /** 주어진 키의 디버그 데이터를 기록해야 하는지 확인합니다. 구독 필터가 없다면 모든 키가 기록됩니다. */
+    bool is_debug_data_subscribed(kangsw::hash_index key) const { return !debug_filter_ || debug_filter_->contains(key); }
 
     /**
      * 옵션의 더티 여부 확인 및 플래그 제거
@@ -134,24 +189,54 @@ public:                    // internal public methods
     void _clear_records(); // invoke() 이전 호출
     void _internal__set_option(detail::option_base* opt) { options_ = opt; }
     void _swap_data_buff(); // invoke() 이후 호출
+    void _set_recording(bool recording) { recording_ = recording; }
+    void _set_debug_filter(std::shared_ptr<debug_filter_type const> filter) { debug_filter_ = std::move(filter); }
+
+    /**
+     * 이번 실행에서 사용할 옵션 스냅샷을 참조합니다. 실행 스레드에서 invoke() 이전에 한 번 호출하며, 실행 중의 모든 옵션 읽기는 이 스냅샷을 사용합니다.
+     * bound가 주어지면(처리할 fence에 묶인 스냅샷) 그것을, 아니면 최신 스냅샷을 사용합니다.
+     */
+    void _refresh_option_snapshot(std::shared_ptr<detail::option_snapshot const> bound = nullptr);
+    detail::option_snapshot const* _option_snapshot() const { return option_snapshot_.get(); }
 
     /**
-     * 읽기 버퍼를 추출합니다.
-     * 다음 _clear_records() 호출 전까지 데이터를 추출할 수 없는 상태가 됩니다.
+     * 실행 도중 이 문맥을 통해 옵션을 변경한 뒤 호출해, 이후의 읽기가 변경된 값을 보도록 합니다.
+     * 이전 스냅샷은 다음 실행 전까지 유지되므로, 이미 반환된 옵션 참조는 계속 유효합니다.
+     */
+    void _adopt_option_snapshot();
+
+    /** 현재 기록 중인 버퍼를 읽습니다. 실행 스레드에서 _swap_data_buff() 이전에만 호출해야 합니다. */
+    execution_context_data const& _peek_write_buffer() const { return *context_data_[write_index_]; }
+
+    /**
+     * 가장 최근에 게시된 버퍼를 추출합니다.
+     * 다음 _swap_data_buff() 호출 전까지 데이터를 추출할 수 없는 상태가 됩니다.
      */
     std::shared_ptr<execution_context_data> _consume_read_buffer();
 
 private: // private methods
-    auto& _rd() { return context_data_[!front_data_buffer_]; }
-    auto& _wr() { return context_data_[front_data_buffer_]; }
+    auto& _wr() { return context_data_[write_index_]; }
+    execution_context_data::debug_data_entity& _emplace_debug_data(interned_name name);
+
+    template <typename Ty_>
+    static void _assign_debug_data(execution_context_data::debug_variant& data, Ty_&& value);
 
 private:
     class detail::option_base* options_ = {};
+    std::shared_ptr<detail::option_snapshot const> option_snapshot_;
+    std::vector<std::shared_ptr<detail::option_snapshot const>> retired_option_snapshots_;
+
+    /** 대기 버퍼 인덱스와, 읽지 않은 결과가 있는지를 나타내는 비트를 함께 저장합니다. */
+    static constexpr uint8_t pending_index_mask = 0b011;
+    static constexpr uint8_t pending_fresh_bit = 0b100;
 
-    std::array<std::shared_ptr<execution_context_data>, 2> context_data_;
-    bool front_data_buffer_ = false;
-    kangsw::spinlock swap_lock_;
-    std::atomic_flag rd_buf_valid_;
+    std::array<std::shared_ptr<execution_context_data>, 3> context_data_;
+    uint8_t write_index_ = 0;
+    uint8_t read_index_ = 2;
+    std::atomic_uint8_t pending_ = 1;
+    kangsw::spinlock consume_lock_; // 읽는 쪽끼리만 경합합니다.
+    bool recording_ = true;
+    std::shared_ptr<debug_filter_type const> debug_filter_;
 
     std::atomic_flag inv_opt_dirty_;
 
@@ -160,15 +245,31 @@ private:
 };
 
 template <typename Ty_>
-void execution_context::store_debug_data(kangsw::hash_pack hp, Ty_&& value)
+void execution_context::store_debug_data(interned_name name, Ty_&& value)
+{
+    if (!recording_) { return; }
+
+    auto& entity = _emplace_debug_data(name);
+    if (is_debug_data_subscribed(name.hash)) {
+        _assign_debug_data(entity.data, std::forward<Ty_>(value));
+    }
+}
+
+template <typename Fn_> requires std::invocable<Fn_&>
+void execution_context::store_debug_data(interned_name name, Fn_&& make_value)
+{
+    if (!recording_) { return; }
+
+    auto& entity = _emplace_debug_data(name);
+    if (is_debug_data_subscribed(name.hash)) {
+        _assign_debug_data(entity.data, make_value());
+    }
+}
+
+template <typename Ty_>
+void execution_context::_assign_debug_data(execution_context_data::debug_variant& data, Ty_&& value)
 {
     using type = std::decay_t<Ty_>;
-    auto& entity = _wr()->debug_data.emplace_back();
-    entity.category_level = category_level_;
-    entity.name = string_pool()(hp).second;
-    entity.category_id = category_id_.back();
-    entity.order = _wr()->debug_data.size() + _wr()->timers.size();
-    auto& data = entity.data;
 
     if constexpr (std::is_same_v<bool, type>) {
         data = value;
@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "pipepp/load_generator.hpp"
+
+namespace pipepp {
+/**
+ * 파이프별 실행기 개수를 자동으로 결정하는 도구입니다.
+ *
+ * 모든 파이프의 실행기를 하나로 시작해, 대표 입력을 목표 도착률로 open-loop 공급하는 시행을 반복합니다.
+ * 각 시행은 trial_duration 동안(최소 min_fences_per_trial개의 fence) 대표 입력을 순환하며 공급하므로, 입력의 개수와 무관하게 통계적으로 의미 있는 수의 fence를 측정합니다.
+ * 목표를 만족하지 못하면 측정된 사용률(누적 실행 시간 / (경과 시간 * 실행기 개수))이 가장 높은 파이프의 실행기를 하나 늘립니다.
+ * 실행기 하나를 늘릴 때마다 다시 측정하므로, 결과는 목표를 만족하는 실행기 총 개수가 가장 적은 구성에 가깝습니다.
+ *
+ * 결과는 pipeline_base::import_executor_counts()로 그대로 불러올 수 있는 json입니다.
+ */
+template <typename Pipeline_>
+class executor_autotuner {
+public:
+    using pipeline_type = Pipeline_;
+    using input_type = typename pipeline_type::input_type;
+    using generator_type = load_generator<pipeline_type>;
+    using report_type = typename generator_type::report_type;
+
+    struct target_type {
+        double throughput_hz = 0;                  // 입력 도착률
+        std::chrono::nanoseconds latency_p99 = {}; // 0이면 지연 조건을 검사하지 않습니다.
+        double max_drop_rate = 0.;
+        std::chrono::milliseconds trial_duration{1000}; // 시행 한 번의 공급 시간
+        size_t min_fences_per_trial = 100;
+        size_t max_executors_per_pipe = 16;
+        size_t max_trials = 64;
+    };
+
+    struct trial_type {
+        nlohmann::json executor_counts;
+        report_type report;
+        std::chrono::nanoseconds latency_p99;
+        bool satisfied;
+    };
+
+public:
+    /**
+     * @param factory 아직 시동하지 않은 파이프라인과, 지연을 측정할 파이프의 프록시를 std::pair로 반환하는 함수.
+     *                시행마다 새 파이프라인을 생성하기 위해 여러 번 호출됩니다.
+     * @param inputs 순서대로 반복 공급할 대표 입력
+     */
+    template <typename Factory_>
+    executor_autotuner(Factory_ factory, std::vector<input_type> inputs)
+    {
+        if (inputs.empty()) { throw pipe_exception("autotuner requires at least one input"); }
+
+        trial_ = [factory = std::move(factory), inputs = std::move(inputs)](nlohmann::json const& counts, typename generator_type::arrival_list const& arrivals) {
+            auto [pipeline, sink] = factory();
+            pipeline->import_executor_counts(counts);
+
+            generator_type generator{pipeline, sink, [&inputs](size_t i) { return inputs[i % inputs.size()]; }};
+            pipeline->launch();
+
+            measurement_type result;
+            result.report = generator.run(arrivals);
+            result.latency_p99 = generator.latency().percentile(99);
+            for (auto& item : counts.at("___executors").items()) {
+                result.busy_time[item.key()] = pipeline->get_pipe(item.key())->total_busy_time();
+            }
+            return result;
+        };
+
+        auto [pipeline, sink] = factory();
+        pipeline->export_executor_counts(initial_counts_);
+        for (auto& item : initial_counts_["___executors"].items()) { item.value() = 1; }
+    }
+
+public:
+    /**
+     * 목표를 만족하는 구성을 찾을 때까지 시행을 반복합니다.
+     * 시행 횟수나 실행기 개수 제한에 먼저 도달하면 마지막 구성을 반환하며, 이때 trials().back().satisfied는 false입니다.
+     */
+    nlohmann::json tune(target_type const& target)
+    {
+        if (target.throughput_hz <= 0) { throw pipe_exception("target throughput must be positive"); }
+
+        auto num_fences = std::max(target.min_fences_per_trial, size_t(std::ceil(target.throughput_hz * std::chrono::duration<double>(target.trial_duration).count())));
+        auto arrivals = generator_type::fixed_rate(target.throughput_hz, num_fences);
+        auto counts = initial_counts_;
+        trials_.clear();
+
+        while (trials_.size() < target.max_trials) {
+            auto result = trial_(counts, arrivals);
+            bool satisfied = result.report.num_completed > 0
+                             && result.report.drop_rate() <= target.max_drop_rate
+                             && (target.latency_p99.count() == 0 || result.latency_p99 <= target.latency_p99);
+            trials_.push_back({counts, result.report, result.latency_p99, satisfied});
+            if (satisfied) { break; }
+
+            // 실행기를 더 늘릴 수 있는 파이프 중 가장 바쁜 파이프를 선택합니다.
+            std::string busiest;
+            double max_utilization = -1;
+            for (auto& item : counts["___executors"].items()) {
+                auto num_execs = item.value().template get<size_t>();
+                if (num_execs >= target.max_executors_per_pipe) { continue; }
+
+                auto utilization = double(result.busy_time[item.key()].count()) / (double(result.report.elapsed.count()) * num_execs);
+                if (utilization > max_utilization) { busiest = item.key(), max_utilization = utilization; }
+            }
+
+            if (busiest.empty()) { break; }
+            auto& count = counts["___executors"][busiest];
+            count = count.template get<size_t>() + 1;
+        }
+
+        return counts;
+    }
+
+    auto& trials() const { return trials_; }
+
+private:
+    struct measurement_type {
+        report_type report;
+        std::chrono::nanoseconds latency_p99;
+        std::map<std::string, std::chrono::nanoseconds> busy_time;
+    };
+
+    nlohmann::json initial_counts_;
+    std::function<measurement_type(nlohmann::json const&, typename generator_type::arrival_list const&)> trial_;
+    std::vector<trial_type> trials_;
+};
+
+} // namespace pipepp
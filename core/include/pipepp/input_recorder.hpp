@@ -0,0 +1,232 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pipepp/pipeline.hpp"
+
+namespace pipepp {
+namespace detail {
+/**
+ * 입력 기록 파일 형식
+ *
+ *  header : magic(4) version(u32)
+ *  record : timestamp_ns(u64) input_size(u32) input(...) shared_size(u32) shared(...)
+ *
+ * 모든 정수는 호스트 바이트 순서로 기록됩니다.
+ */
+inline constexpr char input_record_magic[4] = {'P', 'P', 'I', 'R'};
+inline constexpr uint32_t input_record_version = 1;
+
+template <typename Ty_>
+void write_pod(std::ostream& os, Ty_ value) { os.write(reinterpret_cast<char const*>(&value), sizeof value); }
+
+template <typename Ty_>
+bool read_pod(std::istream& is, Ty_& value) { return !!is.read(reinterpret_cast<char*>(&value), sizeof value); }
+} // namespace detail
+
+/**
+ * 파이프라인의 suply() 호출을 관찰해, 입력과 shared data 초기값, 도착 시각을 이진 파일로 기록합니다.
+ * 입력 형식의 직렬화는 사용자가 제공합니다. shared data 직렬화 함수를 지정하지 않으면 입력만 기록됩니다.
+ *
+ * 기록기는 생성 시 파이프라인의 suply 관찰자로 등록되며, stop() 또는 소멸 시 해제됩니다.
+ * 여러 스레드에서 suply()를 호출해도 기록은 직렬화됩니다. 관찰자는 기록 상태를 공유 소유하므로,
+ * 해제 직전에 시작된 suply()가 기록기 소멸 후에 관찰자를 호출하더라도 닫힌 파일에는 기록하지 않습니다.
+ */
+template <typename Pipeline_>
+class input_recorder {
+public:
+    using pipeline_type = Pipeline_;
+    using input_type = typename pipeline_type::input_type;
+    using shared_data_type = typename pipeline_type::shared_data_type;
+    using input_writer_type = std::function<void(std::ostream&, input_type const&)>;
+    using shared_writer_type = std::function<void(std::ostream&, shared_data_type const&)>;
+
+public:
+    input_recorder(std::shared_ptr<pipeline_type> pipeline,
+                   std::filesystem::path const& path,
+                   input_writer_type input_writer,
+                   shared_writer_type shared_writer = {})
+        : pipeline_(std::move(pipeline))
+        , state_(std::make_shared<state_type>())
+    {
+        auto& state = *state_;
+        state.file.open(path, std::ios::binary | std::ios::trunc);
+        state.input_writer = std::move(input_writer);
+        state.shared_writer = std::move(shared_writer);
+
+        if (!state.file) { throw pipe_exception("failed to open input record file"); }
+        state.file.write(detail::input_record_magic, sizeof detail::input_record_magic);
+        detail::write_pod(state.file, detail::input_record_version);
+
+        pipeline_->set_suply_observer([state = state_](input_type const& input, shared_data_type const& shared) { state->record(input, shared); });
+    }
+
+    ~input_recorder() { stop(); }
+
+    input_recorder(input_recorder const&) = delete;
+    input_recorder& operator=(input_recorder const&) = delete;
+
+public:
+    /** 기록을 중단하고 파일을 닫습니다. */
+    void stop()
+    {
+        if (pipeline_) { pipeline_->set_suply_observer({}); }
+        pipeline_.reset();
+
+        std::lock_guard lock{state_->lock};
+        if (state_->file.is_open()) { state_->file.close(); }
+    }
+
+    size_t num_records() const
+    {
+        std::lock_guard lock{state_->lock};
+        return state_->num_records;
+    }
+
+private:
+    /** 관찰자와 공유하는 기록 상태. 모든 멤버는 lock으로 보호됩니다. */
+    struct state_type {
+        void record(input_type const& input, shared_data_type const& shared)
+        {
+            using namespace std::chrono;
+            std::lock_guard guard{lock};
+            if (!file.is_open()) { return; }
+
+            auto timestamp = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+
+            buffer.str({});
+            input_writer(buffer, input);
+            auto input_bytes = buffer.str();
+
+            buffer.str({});
+            if (shared_writer) { shared_writer(buffer, shared); }
+            auto shared_bytes = buffer.str();
+
+            detail::write_pod(file, static_cast<uint64_t>(timestamp));
+            detail::write_pod(file, static_cast<uint32_t>(input_bytes.size()));
+            file.write(input_bytes.data(), input_bytes.size());
+            detail::write_pod(file, static_cast<uint32_t>(shared_bytes.size()));
+            file.write(shared_bytes.data(), shared_bytes.size());
+            ++num_records;
+        }
+
+        mutable std::mutex lock;
+        std::ofstream file;
+        std::ostringstream buffer;
+        input_writer_type input_writer;
+        shared_writer_type shared_writer;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        size_t num_records = 0;
+    };
+
+private:
+    std::shared_ptr<pipeline_type> pipeline_;
+    std::shared_ptr<state_type> state_;
+};
+
+/**
+ * input_recorder로 기록한 파일을 읽어 파이프라인에 다시 공급합니다.
+ * 모든 기록은 생성 시 메모리로 읽어들이므로, 재생 중에는 파일 입출력이 발생하지 않습니다.
+ */
+template <typename Pipeline_>
+class input_replayer {
+public:
+    using pipeline_type = Pipeline_;
+    using input_type = typename pipeline_type::input_type;
+    using shared_data_type = typename pipeline_type::shared_data_type;
+    using input_reader_type = std::function<void(std::istream&, input_type&)>;
+    using shared_reader_type = std::function<void(std::istream&, shared_data_type&)>;
+
+    enum class rate {
+        original,    // 기록된 도착 간격을 그대로 따릅니다.
+        accelerated, // 도착 간격을 speedup 배만큼 줄입니다.
+        maximum      // 파이프라인이 입력을 받을 수 있게 되는 즉시 공급합니다.
+    };
+
+    struct record_type {
+        std::chrono::nanoseconds timestamp;
+        input_type input;
+        std::string shared;
+    };
+
+public:
+    input_replayer(std::filesystem::path const& path,
+                   input_reader_type input_reader,
+                   shared_reader_type shared_reader = {})
+        : shared_reader_(std::move(shared_reader))
+    {
+        std::ifstream file(path, std::ios::binary);
+        char magic[4];
+        uint32_t version;
+        if (!file.read(magic, sizeof magic) || !std::equal(magic, magic + 4, detail::input_record_magic)
+            || !detail::read_pod(file, version) || version != detail::input_record_version) {
+            throw pipe_exception("invalid input record file");
+        }
+
+        for (uint64_t timestamp; detail::read_pod(file, timestamp);) {
+            auto& record = records_.emplace_back();
+            record.timestamp = std::chrono::nanoseconds(timestamp);
+
+            uint32_t size;
+            std::string bytes;
+            if (!detail::read_pod(file, size) || !file.read((bytes.resize(size), bytes.data()), size)) {
+                throw pipe_exception("truncated input record file");
+            }
+            std::istringstream input_stream(std::move(bytes));
+            input_reader(input_stream, record.input);
+
+            if (!detail::read_pod(file, size) || !file.read((record.shared.resize(size), record.shared.data()), size)) {
+                throw pipe_exception("truncated input record file");
+            }
+        }
+    }
+
+public:
+    auto& records() const { return records_; }
+    size_t size() const { return records_.size(); }
+
+    /**
+     * 기록된 모든 입력을 순서대로 공급합니다. 파이프라인이 입력을 받을 수 없다면 받을 수 있을 때까지 대기하므로,
+     * 어떤 재생 속도에서도 입력이 누락되지 않습니다.
+     *
+     * @return 공급한 입력 개수
+     */
+    size_t play(pipeline_type& pipeline, rate mode = rate::original, double speedup = 1.0) const
+    {
+        using namespace std::chrono;
+        auto const begin = steady_clock::now();
+        double const scale = mode == rate::accelerated ? 1.0 / speedup : 1.0;
+        size_t num_supplied = 0;
+
+        for (auto& record : records_) {
+            if (mode != rate::maximum) {
+                std::this_thread::sleep_until(begin + duration_cast<steady_clock::duration>(record.timestamp * scale));
+            }
+
+            auto init = [&](shared_data_type& shared) {
+                if (!shared_reader_ || record.shared.empty()) { return; }
+                std::istringstream shared_stream(record.shared);
+                shared_reader_(shared_stream, shared);
+            };
+
+            while (!pipeline.suply(record.input, init)) { pipeline.wait_supliable(); }
+            ++num_supplied;
+        }
+
+        return num_supplied;
+    }
+
+private:
+    std::vector<record_type> records_;
+    shared_reader_type shared_reader_;
+};
+
+} // namespace pipepp
@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#ifndef PIPEPP_USE_TSC_CLOCK
+#define PIPEPP_USE_TSC_CLOCK 0
+#endif
+
+#if PIPEPP_USE_TSC_CLOCK
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#error "PIPEPP_USE_TSC_CLOCK requires an x86 target"
+#endif
+#endif
+
+namespace pipepp {
+#if PIPEPP_USE_TSC_CLOCK
+/**
+ * 타임 스탬프 카운터(TSC)를 직접 읽어 나노초로 환산하는 단조 시계입니다.
+ *
+ * 정적 초기화 시점에 steady_clock을 기준으로 한 번 보정하며(약 20ms), 이후의 now()는 카운터 읽기와 곱셈 한 번으로 끝납니다.
+ * 정적 초기화 순서와 무관하게 보정이 끝나도록 pipeline_base::launch()에서도 보정을 보장하므로, 실행기 안의 첫 now()가 보정을 기다리는 일은 없습니다.
+ * 모든 코어의 카운터가 같은 주기로 증가하는 불변 TSC(invariant TSC)를 가정합니다.
+ */
+class tsc_clock {
+public:
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<tsc_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+        auto& c = _calibration();
+        auto ticks = static_cast<int64_t>(__rdtsc() - c.tsc_origin);
+        return time_point{duration{c.ns_origin + static_cast<rep>(ticks * c.ns_per_tick)}};
+    }
+
+public:
+    struct calibration_type {
+        uint64_t tsc_origin;
+        rep ns_origin;
+        double ns_per_tick;
+    };
+
+    static calibration_type const& _calibration() noexcept
+    {
+        static calibration_type const c = _calibrate();
+        return c;
+    }
+
+private:
+    static calibration_type _calibrate() noexcept;
+};
+
+/** 파이프라인의 모든 타이머 스코프와 지연 측정에 사용하는 시계 */
+using instrument_clock = tsc_clock;
+#else
+/** 파이프라인의 모든 타이머 스코프와 지연 측정에 사용하는 시계. PIPEPP_USE_TSC_CLOCK=1로 빌드하면 tsc_clock을 사용합니다. */
+using instrument_clock = std::chrono::steady_clock;
+#endif
+
+} // namespace pipepp
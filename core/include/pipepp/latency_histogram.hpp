@@ -0,0 +1,160 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace pipepp {
+/**
+ * 로그 간격 버킷으로 지연 시간 분포를 기록하는 히스토그램입니다.
+ *
+ * 각 2의 거듭제곱 구간을 16개의 선형 하위 버킷으로 나누므로, 1ns부터 수백 년까지 약 6% 이내의 상대 오차로 기록됩니다.
+ * 모든 버킷은 원자적 카운터이므로 여러 스레드에서 잠금 없이 동시에 record()를 호출할 수 있습니다.
+ */
+class latency_histogram {
+public:
+    using duration = std::chrono::nanoseconds;
+
+    static constexpr size_t sub_bucket_bits = 4;
+    static constexpr size_t num_sub_buckets = 1 << sub_bucket_bits;
+    static constexpr size_t num_buckets = (64 - sub_bucket_bits + 1) * num_sub_buckets;
+
+    /**
+     * 버킷 카운터를 복사한 값입니다. 두 시점의 스냅샷 차이로, 공유 히스토그램을 초기화하지 않고 특정 구간의 분포를 구할 수 있습니다.
+     */
+    struct snapshot_type {
+        std::array<uint64_t, num_buckets> buckets = {};
+        uint64_t count = 0;
+
+        friend snapshot_type operator-(snapshot_type a, snapshot_type const& b) noexcept
+        {
+            for (size_t i = 0; i < num_buckets; ++i) { a.buckets[i] -= std::min(a.buckets[i], b.buckets[i]); }
+            a.count -= std::min(a.count, b.count);
+            return a;
+        }
+
+        /** 주어진 백분위(0~100)에 해당하는 버킷의 중간값 */
+        duration percentile(double p) const noexcept
+        {
+            if (count == 0) { return {}; }
+            auto rank = std::clamp<uint64_t>(static_cast<uint64_t>(std::clamp(p, 0., 100.) / 100. * count + 0.5), 1, count);
+
+            uint64_t accum = 0;
+            for (size_t i = 0; i < num_buckets; ++i) {
+                if ((accum += buckets[i]) < rank) { continue; }
+                auto [lower, width] = _bucket_range(i);
+                return duration(lower + width / 2);
+            }
+            return {};
+        }
+    };
+
+public:
+    latency_histogram() { reset(); }
+    latency_histogram(latency_histogram const&) = delete;
+    latency_histogram& operator=(latency_histogram const&) = delete;
+
+public:
+    void record(duration value) noexcept
+    {
+        auto ns = static_cast<uint64_t>(std::max<duration::rep>(0, value.count()));
+        buckets_[_bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+
+        for (auto min = min_.load(std::memory_order_relaxed); ns < min && !min_.compare_exchange_weak(min, ns, std::memory_order_relaxed);) {}
+        for (auto max = max_.load(std::memory_order_relaxed); ns > max && !max_.compare_exchange_weak(max, ns, std::memory_order_relaxed);) {}
+    }
+
+    /** 기록 중에 호출해도 안전하지만, 초기화와 동시에 기록된 값은 일부 통계에만 반영될 수 있습니다. */
+    void reset() noexcept
+    {
+        for (auto& bucket : buckets_) { bucket.store(0, std::memory_order_relaxed); }
+        count_ = 0, sum_ = 0;
+        min_ = std::numeric_limits<uint64_t>::max(), max_ = 0;
+    }
+
+    size_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+    duration min() const noexcept { return count() ? duration(min_.load()) : duration{}; }
+    duration max() const noexcept { return duration(max_.load()); }
+    duration mean() const noexcept { return count() ? duration(sum_.load() / count()) : duration{}; }
+
+    /**
+     * 주어진 백분위(0~100)에 해당하는 값을 반환합니다. 100 이상이면 최댓값을, 그 외에는 해당 버킷의 중간값을 반환하며, 관측된 최솟값과 최댓값 범위로 제한됩니다.
+     */
+    duration percentile(double p) const noexcept
+    {
+        auto total = count();
+        if (total == 0) { return {}; }
+        if (p >= 100.) { return max(); }
+
+        auto rank = static_cast<uint64_t>(std::clamp(p, 0., 100.) / 100. * total + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, total);
+
+        uint64_t accum = 0;
+        for (size_t i = 0; i < num_buckets; ++i) {
+            if ((accum += buckets_[i].load(std::memory_order_relaxed)) < rank) { continue; }
+
+            auto [lower, width] = _bucket_range(i);
+            auto value = std::clamp(lower + width / 2, min_.load(), max_.load());
+            return duration(value);
+        }
+
+        return max();
+    }
+
+    snapshot_type snapshot() const noexcept
+    {
+        snapshot_type out;
+        for (size_t i = 0; i < num_buckets; ++i) {
+            out.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            out.count += out.buckets[i];
+        }
+        return out;
+    }
+
+    /** 다른 히스토그램의 기록을 합칩니다. */
+    void merge(latency_histogram const& other) noexcept
+    {
+        for (size_t i = 0; i < num_buckets; ++i) {
+            buckets_[i].fetch_add(other.buckets_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        count_ += other.count_.load(), sum_ += other.sum_.load();
+
+        auto ns = other.min_.load();
+        for (auto min = min_.load(); ns < min && !min_.compare_exchange_weak(min, ns);) {}
+        ns = other.max_.load();
+        for (auto max = max_.load(); ns > max && !max_.compare_exchange_weak(max, ns);) {}
+    }
+
+public:
+    static size_t _bucket_index(uint64_t ns) noexcept
+    {
+        if (ns < num_sub_buckets) { return ns; }
+        size_t magnitude = std::bit_width(ns) - 1;
+        size_t shift = magnitude - sub_bucket_bits;
+        return (shift + 1) * num_sub_buckets + ((ns >> shift) - num_sub_buckets);
+    }
+
+    /** @return 버킷의 [하한, 폭] */
+    static std::pair<uint64_t, uint64_t> _bucket_range(size_t index) noexcept
+    {
+        if (index < num_sub_buckets) { return {index, 1}; }
+        size_t shift = index / num_sub_buckets - 1;
+        uint64_t sub = index % num_sub_buckets;
+        return {(num_sub_buckets + sub) << shift, uint64_t(1) << shift};
+    }
+
+private:
+    std::array<std::atomic_uint64_t, num_buckets> buckets_;
+    std::atomic_uint64_t count_;
+    std::atomic_uint64_t sum_;
+    std::atomic_uint64_t min_;
+    std::atomic_uint64_t max_;
+};
+
+} // namespace pipepp
@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "pipepp/latency_histogram.hpp"
+#include "pipepp/pipeline.hpp"
+
+namespace pipepp {
+/**
+ * 정해진 도착 일정에 따라 파이프라인에 입력을 공급하는 open-loop 부하 생성기입니다.
+ *
+ * 파이프라인이 입력을 받을 수 없는 시점에 도착한 입력은 기다리지 않고 버려지므로, 포화 상태의 대기열 지연과 손실률을 그대로 관찰할 수 있습니다.
+ * 지연 시간은 도착 일정에 예정된 시각부터 측정 대상 파이프의 출력 핸들러가 호출될 때까지의 시간입니다.
+ * 생성기가 입력 생성 등으로 예정보다 늦게 공급하더라도 그 지연이 측정에서 누락되지 않습니다. run() 밖에서 공급된 fence는 launch_time_point()부터 측정합니다.
+ * 지연 생성된 실행기의 생성 비용이 포함된 fence(base_shared_context::is_warm_up_fence())는 완료 개수에만 포함되고, 지연 분포에서는 제외됩니다.
+ */
+template <typename Pipeline_>
+class load_generator {
+public:
+    using pipeline_type = Pipeline_;
+    using input_type = typename pipeline_type::input_type;
+    using shared_data_type = typename pipeline_type::shared_data_type;
+    using input_factory_type = std::function<input_type(size_t)>;
+    using arrival_list = std::vector<std::chrono::nanoseconds>;
+
+    struct report_type {
+        size_t num_offered = 0;
+        size_t num_supplied = 0;
+        size_t num_dropped = 0;
+        size_t num_completed = 0;
+        std::chrono::nanoseconds elapsed = {};
+
+        double drop_rate() const { return num_offered ? double(num_dropped) / num_offered : 0.; }
+        double throughput() const { return elapsed.count() ? num_completed * 1e9 / elapsed.count() : 0.; }
+    };
+
+public:
+    /**
+     * 측정 대상 파이프에 출력 핸들러를 등록하므로, 파이프라인을 launch()하기 전에 생성해야 합니다.
+     */
+    template <typename SinkProxy_>
+    load_generator(std::shared_ptr<pipeline_type> pipeline, SinkProxy_ sink, input_factory_type make_input)
+        : pipeline_(std::move(pipeline))
+        , make_input_(std::move(make_input))
+        , state_(std::make_shared<state_type>())
+    {
+        sink.add_output_handler([state = state_](shared_data_type const& sd) {
+            auto const now = instrument_clock::now();
+            auto const arrival = state->take_arrival(sd);
+
+            if (sd.is_warm_up_fence()) {
+                state->num_warm_up.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                state->latency.record(now - arrival);
+            }
+        });
+    }
+
+public:
+    /** 일정한 간격의 도착 일정 */
+    static arrival_list fixed_rate(double rate_hz, size_t count)
+    {
+        arrival_list arrivals(count);
+        for (size_t i = 0; i < count; ++i) { arrivals[i] = std::chrono::nanoseconds(int64_t(i * 1e9 / rate_hz)); }
+        return arrivals;
+    }
+
+    /** 평균 rate_hz의 포아송 과정을 따르는 도착 일정 */
+    static arrival_list poisson(double rate_hz, size_t count, uint64_t seed = std::random_device{}())
+    {
+        std::mt19937_64 rng{seed};
+        std::exponential_distribution<double> interval{rate_hz};
+
+        arrival_list arrivals(count);
+        double at = 0;
+        for (auto& arrival : arrivals) {
+            arrival = std::chrono::nanoseconds(int64_t(at * 1e9));
+            at += interval(rng);
+        }
+        return arrivals;
+    }
+
+    /** 기록된 도착 시각 목록을 재생합니다. 같은 시각에 여러 입력이 몰린 버스트도 그대로 재현됩니다. */
+    static arrival_list trace(arrival_list timestamps, double speedup = 1.0)
+    {
+        std::ranges::sort(timestamps);
+        auto origin = timestamps.empty() ? std::chrono::nanoseconds{} : timestamps.front();
+        for (auto& ts : timestamps) { ts = std::chrono::nanoseconds(int64_t((ts - origin).count() / speedup)); }
+        return timestamps;
+    }
+
+public:
+    /**
+     * 도착 일정에 따라 입력을 공급하고, 모든 fence가 처리될 때까지 대기한 뒤 결과를 반환합니다.
+     * 호출 시 지연 시간 히스토그램은 초기화됩니다.
+     */
+    template <typename Fn_ = void (*)(shared_data_type&)>
+    report_type run(
+      arrival_list const& arrivals, Fn_&& shared_data_init_func = [](shared_data_type&) {})
+    {
+        using namespace std::chrono;
+        pipeline_->sync();
+        state_->latency.reset();
+        state_->num_warm_up.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard lock{state_->arrival_lock};
+            state_->arrivals.clear();
+        }
+
+        report_type report;
+        auto const begin = steady_clock::now();
+        auto const schedule_origin = instrument_clock::now();
+
+        for (size_t i = 0; i < arrivals.size(); ++i) {
+            std::this_thread::sleep_until(begin + duration_cast<steady_clock::duration>(arrivals[i]));
+            auto const scheduled = schedule_origin + duration_cast<instrument_clock::duration>(arrivals[i]);
+
+            // fence 객체는 처리가 끝나기 전까지 재사용되지 않으므로, 객체 주소로 예정 도착 시각을 찾을 수 있습니다.
+            // 공급에 실패한 fence 객체의 기록은 그 객체가 다시 공급될 때 덮어씁니다.
+            auto init = [&](shared_data_type& sd) {
+                shared_data_init_func(sd);
+                std::lock_guard lock{state_->arrival_lock};
+                state_->arrivals[&sd] = scheduled;
+            };
+
+            ++report.num_offered;
+            if (pipeline_->suply(make_input_(i), init)) {
+                ++report.num_supplied;
+            } else {
+                ++report.num_dropped;
+            }
+        }
+
+        pipeline_->sync();
+        report.elapsed = duration_cast<nanoseconds>(steady_clock::now() - begin);
+        report.num_completed = state_->latency.count() + state_->num_warm_up.load(std::memory_order_relaxed);
+        return report;
+    }
+
+    latency_histogram const& latency() const { return state_->latency; }
+
+private:
+    struct state_type {
+        /** 예정 도착 시각을 꺼내고 기록을 지웁니다. run()으로 공급되지 않은 fence라면 launch_time_point()를 반환합니다. */
+        instrument_clock::time_point take_arrival(shared_data_type const& sd)
+        {
+            std::lock_guard lock{arrival_lock};
+            auto it = arrivals.find(&sd);
+            if (it == arrivals.end()) { return sd.launch_time_point(); }
+
+            auto arrival = it->second;
+            arrivals.erase(it);
+            return arrival;
+        }
+
+        latency_histogram latency;
+        std::atomic_size_t num_warm_up = 0;
+
+        std::mutex arrival_lock;
+        std::unordered_map<base_shared_context const*, instrument_clock::time_point> arrivals; // 공급 중인 fence 객체별 예정 도착 시각
+    };
+
+    std::shared_ptr<pipeline_type> pipeline_;
+    input_factory_type make_input_;
+    std::shared_ptr<state_type> state_;
+};
+
+} // namespace pipepp
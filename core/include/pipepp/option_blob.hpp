@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "nlohmann/json.hpp"
+
+namespace pipepp {
+namespace detail {
+/** 핸들이 가리키는 blob 버퍼 */
+struct blob_buffer {
+    std::shared_ptr<std::byte const> data;
+    size_t num_bytes = 0;
+};
+
+/**
+ * 정렬된 blob 버퍼를 프로세스 전역 테이블에 등록하고 핸들을 발급합니다. 0은 빈 blob을 나타내므로 발급하지 않습니다.
+ * 테이블은 약한 참조만 보관하므로, 버퍼는 이를 참조하는 option_blob과 옵션(option_base, option_specification)이 모두 사라지면 해제됩니다.
+ */
+uint64_t register_blob(std::shared_ptr<std::byte const> data, size_t num_bytes);
+
+/** 핸들이 가리키는 버퍼. 알 수 없거나 이미 해제된 핸들이라면 data가 비어 있습니다. */
+blob_buffer find_blob(uint64_t handle);
+
+/** json 값이 blob 핸들({"___blob": 핸들, "size": 바이트 수})인지 검사합니다. */
+inline bool is_blob_handle(nlohmann::json const& j)
+{
+    return j.is_object() && j.contains("___blob");
+}
+
+/** json 값과 그 하위 값이 참조하는 blob 핸들마다 fn을 호출합니다. */
+template <typename Fn_>
+void for_each_blob_handle(nlohmann::json const& j, Fn_&& fn)
+{
+    if (is_blob_handle(j)) {
+        fn(j.at("___blob").get<uint64_t>());
+    } else if (j.is_structured()) {
+        for (auto& elem : j) { for_each_blob_handle(elem, fn); }
+    }
+}
+
+/** json 값이 참조하는 blob 버퍼의 강한 참조를 모읍니다. 옵션이 핸들만 보관하는 동안 버퍼가 해제되지 않게 합니다. */
+inline void collect_blob_refs(nlohmann::json const& j, std::vector<std::shared_ptr<std::byte const>>& refs)
+{
+    for_each_blob_handle(j, [&](uint64_t handle) {
+        if (auto buffer = find_blob(handle); buffer.data) { refs.push_back(std::move(buffer.data)); }
+    });
+}
+} // namespace detail
+
+/**
+ * 룩업 테이블, 커널, 가중치처럼 큰 배열을 옵션으로 보관하기 위한 불변 연속 배열입니다.
+ *
+ * 값은 alignment 경계에 정렬된 한 덩어리의 메모리에 보관되며, 복사는 참조만 공유합니다.
+ * 옵션 json에는 값 대신 핸들({"___blob": 핸들, "size": 바이트 수})만 저장되므로, 옵션 json의 복사와 비교는 blob 크기와 무관합니다.
+ * 핸들로부터 읽을 때도 같은 버퍼를 공유하므로, 실행기가 스냅샷에서 읽는 span은 옵션에 기록한 메모리 그 자체입니다.
+ *
+ * 내보내기에서는 바이트열이 옵션 값과 분리된 ___blobs 섹션으로 옮겨지고, 불러오기에서 다시 핸들로 연결됩니다(pipeline_base::export_options()).
+ * 바이트 순서는 변환하지 않으므로, 내보낸 값은 같은 바이트 순서의 플랫폼에서만 불러올 수 있습니다.
+ */
+template <typename Ty_>
+requires std::is_trivially_copyable_v<Ty_>
+class option_blob {
+public:
+    using value_type = Ty_;
+    static constexpr size_t alignment = std::max<size_t>(alignof(Ty_), 64);
+
+public:
+    option_blob() = default;
+    option_blob(std::span<Ty_ const> values) { _assign(values.data(), values.size_bytes()); }
+    option_blob(std::initializer_list<Ty_> values) { _assign(values.begin(), values.size() * sizeof(Ty_)); }
+    option_blob(std::vector<Ty_> const& values) { _assign(values.data(), values.size() * sizeof(Ty_)); }
+
+    /** 정렬된 메모리에 바이트열을 그대로 복사합니다. 길이는 원소 크기의 배수여야 합니다. */
+    static option_blob from_bytes(void const* data, size_t num_bytes)
+    {
+        if (num_bytes % sizeof(Ty_) != 0) { throw std::invalid_argument("blob size is not a multiple of the element size"); }
+        option_blob blob;
+        blob._assign(data, num_bytes);
+        return blob;
+    }
+
+    /** 핸들이 가리키는 버퍼를 복사 없이 공유합니다. 이미 해제된 핸들이라면 예외를 던집니다. */
+    static option_blob from_handle(uint64_t handle)
+    {
+        if (handle == 0) { return {}; }
+
+        auto buffer = detail::find_blob(handle);
+        if (!buffer.data) { throw std::invalid_argument("blob handle has expired"); }
+        if (reinterpret_cast<uintptr_t>(buffer.data.get()) % alignment != 0) { return from_bytes(buffer.data.get(), buffer.num_bytes); }
+        if (buffer.num_bytes % sizeof(Ty_) != 0) { throw std::invalid_argument("blob size is not a multiple of the element size"); }
+
+        auto values = reinterpret_cast<Ty_ const*>(buffer.data.get());
+        option_blob blob;
+        blob.data_ = std::shared_ptr<Ty_ const>(std::move(buffer.data), values);
+        blob.size_ = buffer.num_bytes / sizeof(Ty_);
+        blob.handle_ = handle;
+        return blob;
+    }
+
+public:
+    std::span<Ty_ const> span() const { return {data_.get(), size_}; }
+    std::span<std::byte const> bytes() const { return std::as_bytes(span()); }
+    Ty_ const* data() const { return data_.get(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    auto begin() const { return span().begin(); }
+    auto end() const { return span().end(); }
+    Ty_ const& operator[](size_t i) const { return data_.get()[i]; }
+
+    /** 옵션 json에 저장되는 핸들. 빈 blob이라면 0입니다. */
+    uint64_t handle() const { return handle_; }
+
+    friend bool operator==(option_blob const& a, option_blob const& b)
+    {
+        return a.data_ == b.data_ || (a.size_ == b.size_ && std::memcmp(a.data(), b.data(), a.size_ * sizeof(Ty_)) == 0);
+    }
+
+private:
+    void _assign(void const* data, size_t num_bytes)
+    {
+        size_ = num_bytes / sizeof(Ty_);
+        if (size_ == 0) { return data_.reset(), void(handle_ = 0); }
+
+        auto buffer = static_cast<Ty_*>(::operator new(num_bytes, std::align_val_t{alignment}));
+        std::memcpy(buffer, data, num_bytes);
+        data_.reset(buffer, [](Ty_ const* p) { ::operator delete(const_cast<Ty_*>(p), std::align_val_t{alignment}); });
+        handle_ = detail::register_blob(std::shared_ptr<std::byte const>(data_, reinterpret_cast<std::byte const*>(buffer)), num_bytes);
+    }
+
+private:
+    std::shared_ptr<Ty_ const> data_;
+    size_t size_ = 0;
+    uint64_t handle_ = 0;
+};
+
+template <typename Ty_>
+void to_json(nlohmann::json& j, option_blob<Ty_> const& blob)
+{
+    j = nlohmann::json::object();
+    j["___blob"] = blob.handle();
+    j["size"] = blob.size() * sizeof(Ty_);
+}
+
+/** json 텍스트로 직렬화된 binary 값({"bytes": [...], "subtype": ...})인지 검사합니다. */
+inline bool _is_serialized_binary(nlohmann::json const& j)
+{
+    return j.is_object() && j.contains("bytes") && j.at("bytes").is_array();
+}
+
+/**
+ * 핸들 외에, binary 값과 json 텍스트로 직렬화된 binary 값, 직접 작성한 설정 파일을 위한 원소별 배열도 받습니다.
+ */
+template <typename Ty_>
+void from_json(nlohmann::json const& j, option_blob<Ty_>& blob)
+{
+    if (detail::is_blob_handle(j)) {
+        blob = option_blob<Ty_>::from_handle(j.at("___blob").get<uint64_t>());
+    } else if (j.is_binary()) {
+        auto& bytes = j.get_binary();
+        blob = option_blob<Ty_>::from_bytes(bytes.data(), bytes.size());
+    } else if (_is_serialized_binary(j)) {
+        auto bytes = j.at("bytes").get<std::vector<uint8_t>>();
+        blob = option_blob<Ty_>::from_bytes(bytes.data(), bytes.size());
+    } else {
+        blob = option_blob<Ty_>{j.get<std::vector<Ty_>>()};
+    }
+}
+
+} // namespace pipepp
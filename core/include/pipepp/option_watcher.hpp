@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace pipepp {
+namespace detail {
+class pipeline_base;
+} // namespace detail
+
+/**
+ * 옵션 파일의 변경을 감시해, 파이프라인 전체에 한 번에 적용합니다.
+ *
+ * 파일은 pipeline_base::export_options()와 같은 형식의 json이며, 변경될 때마다 감시 스레드에서 읽고 파싱합니다.
+ * 파싱과 검증에 성공한 경우에만 pipeline_base::swap_options()로 교체하므로, 실행기는 잘못되었거나 일부만 적용된 옵션을 보지 않습니다.
+ * Linux에서는 inotify로, 그 외의 환경에서는 파일의 수정 시각을 주기적으로 확인해 변경을 감지합니다.
+ */
+class option_file_watcher {
+public:
+    /** 다시 읽을 때마다 감시 스레드에서 호출됩니다. 적용에 실패했다면 error에 사유가 전달됩니다. 잠금 밖에서 호출되므로 감시자의 함수를 호출해도 됩니다. */
+    using reload_handler_type = std::function<void(bool applied, std::string_view error)>;
+
+public:
+    option_file_watcher(
+      std::weak_ptr<detail::pipeline_base> pipeline,
+      std::filesystem::path path,
+      reload_handler_type on_reload = {},
+      std::chrono::milliseconds poll_interval = std::chrono::milliseconds{200});
+    ~option_file_watcher() { stop(); }
+
+    option_file_watcher(option_file_watcher const&) = delete;
+    option_file_watcher& operator=(option_file_watcher const&) = delete;
+
+public:
+    /** 파일을 즉시 다시 읽어 적용합니다. 감시 스레드와 동시에 호출할 수 있습니다. */
+    bool reload();
+
+    /** 감시를 중단합니다. 소멸 시 자동으로 호출됩니다. */
+    void stop();
+
+    auto& path() const { return path_; }
+    size_t num_applied() const { return num_applied_.load(std::memory_order_relaxed); }
+    size_t num_rejected() const { return num_rejected_.load(std::memory_order_relaxed); }
+    std::string last_error() const;
+
+private:
+    void _watch_loop();
+    void _watch_inotify();
+    void _watch_polling();
+
+private:
+    std::weak_ptr<detail::pipeline_base> pipeline_;
+    std::filesystem::path path_;
+    reload_handler_type on_reload_;
+    std::chrono::milliseconds poll_interval_;
+
+    mutable std::mutex reload_lock_;
+    std::string last_error_;
+    std::atomic_size_t num_applied_ = 0;
+    std::atomic_size_t num_rejected_ = 0;
+
+    int inotify_fd_ = -1;
+    std::filesystem::file_time_type last_write_;
+
+    std::atomic_bool stop_ = false;
+    std::thread watcher_;
+};
+
+} // namespace pipepp
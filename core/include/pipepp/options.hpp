@@ -1,13 +1,18 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <set>
 #include <shared_mutex>
 #include <span>
+#include <stdexcept>
 #include <unordered_set>
 #include <variant>
+#include <vector>
 #include "kangsw/helpers/misc.hxx"
 #include "kangsw/thread/spinlock.hxx"
 #include "nlohmann/json.hpp"
+#include "pipepp/execution_context.hpp"
+#include "pipepp/option_blob.hpp"
 
 namespace pipepp {
 namespace detail {
@@ -15,6 +20,42 @@ template <typename Exec_, typename Ty_>
 struct _option_instance;
 using verify_function_t = std::function<bool(nlohmann::json&)>;
 
+/**
+ * 옵션 값을 선언 순서대로 형식 변환해 보관하는 불변 스냅샷입니다.
+ * 옵션을 변경하는 쪽에서 세대가 바뀔 때마다 새로 생성해 게시하며(RCU), 실행기 슬롯은 실행마다 게시된 스냅샷을 한 번 참조해 잠금과 json 조회 없이 옵션을 읽습니다.
+ */
+class option_snapshot {
+    friend class option_base;
+
+public:
+    struct slot_base {
+        virtual ~slot_base() = default;
+    };
+
+    template <typename Ty_>
+    struct slot : slot_base {
+        Ty_ value;
+    };
+
+    using decoder_type = std::function<std::shared_ptr<slot_base const>(nlohmann::json const&)>;
+
+public:
+    size_t generation() const { return generation_; }
+
+    /** spec의 index번째 옵션 값. 다른 실행기의 옵션이라면 nullptr입니다. */
+    template <typename Ty_>
+    Ty_ const* find(void const* spec, size_t index) const
+    {
+        if (spec != spec_ || index >= slots_.size() || !slots_[index]) { return nullptr; }
+        return &static_cast<slot<Ty_> const&>(*slots_[index]).value;
+    }
+
+private:
+    void const* spec_ = nullptr;
+    size_t generation_ = 0;
+    std::vector<std::shared_ptr<slot_base const>> slots_; // 값이 바뀌지 않은 슬롯은 이전 스냅샷과 공유할 수 있습니다.
+};
+
 class option_base final {
     template <typename Exec_, typename Ty_>
     friend struct _option_instance;
@@ -26,6 +67,36 @@ public:
     template <typename Exec_>
     void reset_as_default();
 
+    /**
+     * 옵션 값이 변경될 때마다 증가합니다.
+     * _option_instance를 통한 쓰기는 자동으로 반영되며, value()를 직접 수정했다면 mark_modified()를 호출해야 합니다.
+     * (파이프의 mark_dirty()가 이를 호출합니다.)
+     *
+     * 세대는 모든 option_base가 공유하는 카운터에서 발급되므로, 서로 다른 옵션 집합의 세대도 선후를 비교할 수 있습니다.
+     */
+    size_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    /** 세대를 올리고 새 스냅샷을 게시합니다. 잠금을 잡으므로, 이미 잠금을 잡은 상태라면 _mark_modified()를 호출합니다. */
+    void mark_modified();
+
+    /** mark_modified()와 같으나, 호출자가 lock_write()를 잡고 있어야 합니다. */
+    void _mark_modified();
+
+    /** 지금까지 발급된 가장 최근 세대 */
+    static size_t latest_generation() { return latest_generation_.load(std::memory_order_acquire); }
+
+    /**
+     * 세대가 since보다 늦게 변경된 옵션만 담은 객체를 반환합니다. since가 0이면 모든 옵션을 반환합니다.
+     * 변경 여부는 호출 시점에 마지막으로 기록해 둔 값과 비교해 판단하므로, value()를 직접 수정하고 mark_modified()를 호출하지 않은 경우도 검출됩니다.
+     */
+    nlohmann::json changes_since(size_t since);
+
+    /**
+     * 마지막으로 게시된 스냅샷을 반환합니다. 같은 세대의 스냅샷은 모든 실행기 슬롯이 공유합니다.
+     * 스냅샷은 mark_modified()에서 미리 만들어 두므로, 이 함수는 잠금을 잡지 않고 원자적으로 읽기만 합니다.
+     */
+    std::shared_ptr<option_snapshot const> snapshot() const { return snapshot_.load(std::memory_order_acquire); }
+
     auto lock_read(bool trial = false) const
     {
         return trial ? std::unique_lock{lock_, std::try_to_lock} : std::unique_lock{lock_};
@@ -62,6 +133,21 @@ private:
     std::map<std::string, verify_function_t> verifiers_;
     std::map<std::string, std::string> paths_;
     mutable kangsw::spinlock lock_;
+
+    void const* spec_ = nullptr;
+    std::vector<std::pair<std::string, option_snapshot::decoder_type>> decoders_;
+    std::atomic_size_t generation_ = 0;
+    std::atomic<std::shared_ptr<option_snapshot const>> snapshot_;
+    std::vector<std::shared_ptr<std::byte const>> blob_refs_; // options_가 핸들로 참조하는 option_blob 버퍼
+
+    struct stamp_type {
+        size_t generation = 0;
+        nlohmann::json value;
+    };
+    std::map<std::string, stamp_type> stamps_;
+    size_t stamped_generation_ = 0;
+
+    inline static std::atomic_size_t latest_generation_ = 0;
 };
 
 template <typename Exec_>
@@ -75,6 +161,8 @@ public:
     std::map<std::string, std::string> init_names_;
     std::map<std::string, verify_function_t> init_verifies_;
     std::map<std::string, std::string> paths_;
+    std::vector<std::pair<std::string, option_snapshot::decoder_type>> init_decoders_; // 선언 순서
+    std::vector<std::shared_ptr<std::byte const>> init_blob_refs_;                     // init_values_가 핸들로 참조하는 option_blob 버퍼
 };
 
 template <typename Exec_>
@@ -93,6 +181,9 @@ void option_base::reset_as_default()
     names_ = _opt_spec<Exec_>().init_names_;
     verifiers_ = _opt_spec<Exec_>().init_verifies_;
     paths_ = _opt_spec<Exec_>().paths_;
+    decoders_ = _opt_spec<Exec_>().init_decoders_;
+    spec_ = &_opt_spec<Exec_>();
+    mark_modified();
 }
 
 template <typename Exec_, typename Ty_>
@@ -108,6 +199,7 @@ struct _option_instance {
       std::string desc = "",
       std::function<bool(Ty_&)> verifier = [](auto&) { return true; })
         : key_(category + "." + name)
+        , index_(_opt_spec<Exec_>().init_decoders_.size())
     {
         if (_opt_spec<Exec_>().init_values_.contains(key_)) throw;
 
@@ -123,14 +215,24 @@ struct _option_instance {
 
         _opt_spec<Exec_>().paths_[key_] = path;
         _opt_spec<Exec_>().init_values_[key_] = std::move(initv);
+        collect_blob_refs(_opt_spec<Exec_>().init_values_[key_], _opt_spec<Exec_>().init_blob_refs_);
         _opt_spec<Exec_>().init_categories_[key_] = std::move(category);
         _opt_spec<Exec_>().init_descs_[key_] = std::move(desc);
         _opt_spec<Exec_>().init_names_[key_] = std::move(name);
         _opt_spec<Exec_>().init_verifies_[key_] = std::move(verify);
+        _opt_spec<Exec_>().init_decoders_.emplace_back(key_, [](nlohmann::json const& arg) -> std::shared_ptr<option_snapshot::slot_base const> {
+            auto slot = std::make_shared<option_snapshot::slot<Ty_>>();
+            slot->value = arg.get<Ty_>();
+            return slot;
+        });
     }
 
     template <typename RTy_>
-    void operator()(option_base& o, RTy_&& r) const { o.lock_write(), o.options_[key_] = Ty_(std::forward<RTy_>(r)); }
+    void operator()(option_base& o, RTy_&& r) const { o.lock_write(), o.options_[key_] = Ty_(std::forward<RTy_>(r)), o._mark_modified(); }
+
+    /** 실행 문맥을 통해 변경하면, 같은 실행 안의 이후 읽기에도 변경된 값이 보입니다. */
+    template <typename RTy_>
+    void operator()(execution_context& ctx, RTy_&& r) const { (*this)(ctx.option(), std::forward<RTy_>(r)), ctx._adopt_option_snapshot(); }
     Ty_ operator()(option_base const& o) const
     {
         Ty_ value;
@@ -138,7 +240,19 @@ struct _option_instance {
         return value;
     }
 
+    /**
+     * 실행 문맥이 이번 실행을 위해 참조한 스냅샷에서, 잠금과 json 조회 없이 값을 읽습니다.
+     * 스냅샷은 실행이 끝날 때까지 유지되므로, 반환된 참조는 invoke() 안에서 유효하며 실행 도중 옵션이 변경되어도 바뀌지 않습니다.
+     */
+    Ty_ const& operator()(execution_context const& ctx) const
+    {
+        auto snapshot = ctx._option_snapshot();
+        if (auto value = snapshot ? snapshot->template find<Ty_>(&_opt_spec<Exec_>(), index_) : nullptr) { return *value; }
+        throw std::invalid_argument("option '" + key_ + "' does not belong to the executor of given execution context");
+    }
+
     std::string const key_;
+    size_t const index_;
 };
 
 } // namespace detail
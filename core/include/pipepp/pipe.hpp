@@ -1,11 +1,17 @@
 #pragma once
+#include <algorithm>
 #include <any>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <exception>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "kangsw/helpers/misc.hxx"
@@ -13,11 +19,15 @@
 #include "kangsw/thread/thread_pool.hxx"
 #include "kangsw/thread/thread_utility.hxx"
 #include "pipepp/execution_context.hpp"
+#include "pipepp/latency_histogram.hpp"
 
 namespace pipepp {
 namespace detail {
 class pipeline_base;
-}
+class pipe_base;
+} // namespace detail
+class trace_recorder;
+class critical_path_analyzer;
 
 /** 파이프 에러 형식 */
 enum class pipe_error {
@@ -64,10 +74,29 @@ enum class fence_index_t : size_t { none = 0 };
 /** 각각의 Pipe는 생성 시 부여된 고유한 pipe id를 갖습니다. */
 enum class pipe_id_t : size_t { none = -1 };
 
+/** fence 하나가 파이프를 지나간 시각입니다. 실행되지 않은 파이프의 시각은 모두 기본값입니다. */
+struct fence_stamp {
+    using time_point = instrument_clock::time_point;
+
+    time_point enqueued; // 입력이 실행기 슬롯에 할당된 시각
+    time_point started;  // 작업자 스레드에서 실행을 시작한 시각
+    time_point finished; // 실행기 실행을 마친 시각
+    time_point ordered;  // 출력 순서 대기를 마친 시각
+    time_point linked;   // 모든 출력 링크를 마친 시각
+
+    bool is_executed() const { return linked != time_point{}; }
+};
+
 /** fence shared data의 기본 상속형입니다. */
 struct base_shared_context {
     friend class detail::pipeline_base;
+    friend class detail::pipe_base;
+    base_shared_context() = default;
     virtual ~base_shared_context() = default;
+
+    /** 복사는 파생 클래스의 데이터만을 대상으로 하며, 파이프라인이 관리하는 fence 정보는 복사하지 않습니다. */
+    base_shared_context(base_shared_context const&) {}
+    base_shared_context& operator=(base_shared_context const&) { return *this; }
     auto& option() const noexcept { return global_options_; }
     operator detail::option_base const &() const { return *global_options_; }
     auto launch_time_point() const { return launched_; }
@@ -75,10 +104,56 @@ struct base_shared_context {
     /** shared context를 상속하는 클래스에서 재정의해, 재사용된 shared context의 초기화를 처리할 수 있습니다. */
     virtual void reload() {}
 
+    /** 옵션 변경 후 재실행을 위해 다시 공급된 fence인지 확인합니다. */
+    bool is_replay() const noexcept { return !replay_targets_.empty(); }
+
+    /** 재실행 fence라면 재실행의 원본이 된 fence. 재실행 대상이 아닌 파이프는 이 fence에서 보관한 출력만 재사용합니다. */
+    fence_index_t replay_source() const noexcept { return replay_source_; }
+
+    /**
+     * 지연 생성 모드의 파이프가 이 fence를 처리하면서 실행기를 생성하고 warm-up했는지 확인합니다.
+     * 이 fence의 지연에는 생성 비용이 포함되어 정상 상태를 대표하지 않으므로, 지연, 인터벌 분포와 임계 경로 분석에서 제외됩니다.
+     */
+    bool is_warm_up_fence() const noexcept { return std::atomic_ref{warm_up_}.load(std::memory_order_relaxed); }
+
+    /** 주어진 파이프가 이 fence에서 실행되어야 하는지 확인합니다. 재실행 fence가 아니라면 항상 true입니다. */
+    bool _is_replay_target(pipe_id_t id) const { return !is_replay() || std::ranges::find(replay_targets_, id) != replay_targets_.end(); }
+
+    /** 파이프 인덱스 순서의 통과 시각. 임계 경로 분석이 활성화된 파이프라인에서만 채워집니다. */
+    std::span<fence_stamp const> stamps() const { return stamps_; }
+
+    /**
+     * 이 fence가 발급될 때의 옵션 세대(detail::option_base::latest_generation()).
+     * 이 fence를 처리하는 모든 파이프는 이 시점에 게시된 옵션 스냅샷을 사용하므로, 처리 도중 swap_options()가 호출되어도 한 fence 안에서 옛 옵션과 새 옵션이 섞이지 않습니다.
+     */
+    size_t option_generation() const noexcept { return option_generation_; }
+
+    /** 주어진 인덱스의 파이프가 이 fence에서 사용할 옵션 스냅샷. 파이프라인 밖에서 만들어진 fence라면 nullptr입니다. */
+    std::shared_ptr<detail::option_snapshot const> _option_snapshot(size_t pipe_index) const
+    {
+        return pipe_index < option_snapshots_.size() ? option_snapshots_[pipe_index] : nullptr;
+    }
+
 private:
-    detail::option_base const* global_options_;
-    std::chrono::system_clock::time_point launched_;
-    fence_index_t fence_;
+    detail::option_base const* global_options_ = nullptr;
+    instrument_clock::time_point launched_;
+    fence_index_t fence_ = fence_index_t::none;
+    std::vector<pipe_id_t> replay_targets_;
+    fence_index_t replay_source_ = fence_index_t::none;
+    std::vector<fence_stamp> stamps_;
+    bool stamps_collected_ = true;
+    bool warm_up_ = false; // 여러 파이프가 동시에 기록하므로 atomic_ref로 접근합니다.
+    size_t option_generation_ = 0;
+    std::vector<std::shared_ptr<detail::option_snapshot const>> option_snapshots_; // 파이프 인덱스 순서
+};
+
+/** 각 파이프가 기록하는 시간 분포의 종류 */
+enum class pipe_histogram_t : uint8_t {
+    output_interval, // 연속된 출력 사이의 간격
+    output_latency,  // fence 시동부터 이 파이프의 출력까지의 지연
+    run_time,        // 실행기 실행 시간
+    output_wait,     // 실행 완료 후 출력 순서가 될 때까지의 대기 시간
+    _count
 };
 
 enum class executor_condition_t : uint8_t {
@@ -95,10 +170,23 @@ namespace detail {
 class executor_base {
 public:
     virtual ~executor_base() = default;
-    virtual pipe_error invoke__(std::any& input, std::any& output) = 0;
+
+    /**
+     * 주어진 실행 문맥으로 실행합니다.
+     * stateless 파이프에서는 하나의 실행기 인스턴스가 여러 스레드에서 동시에 호출되므로, 실행 문맥을 매 호출마다 전달합니다.
+     */
+    virtual pipe_error invoke__(execution_context& context, std::any& input, std::any& output) = 0;
+
+    /** 바인딩된 실행 문맥으로 실행합니다. stateless 파이프의 공유 실행기는 문맥이 바인딩되지 않으므로 호출할 수 없습니다. */
+    pipe_error invoke__(std::any& input, std::any& output)
+    {
+        if (context_ == nullptr) { throw pipe_exception("executor has no bound execution context!"); }
+        return invoke__(*context_, input, output);
+    }
 
 public:
     void set_context_ref(execution_context* ref) { context_ = ref, context_->_clear_records(); }
+    void set_workers_ref(kangsw::timer_thread_pool* ref) { workers_ = ref; }
 
     // 실제 실행기의 레퍼런스를 획득합니다.
     // 추후, json_option_interface를 상속하는 실행기 등에 사용
@@ -110,6 +198,7 @@ private:
 
 protected:
     execution_context* context_ = nullptr;
+    kangsw::timer_thread_pool* workers_ = nullptr;
 };
 
 struct pipe_id_gen {
@@ -124,7 +213,7 @@ class pipe_base final : public std::enable_shared_from_this<pipe_base> {
 public:
     using output_link_adapter_type = std::function<bool(base_shared_context&, execution_context&, std::any const& output, std::any& input, option_base const& nxt_opt)>;
     using output_handler_type = std::function<void(pipe_error, base_shared_context&, execution_context&, std::any const&)>;
-    using system_clock = std::chrono::system_clock;
+    using clock = instrument_clock;
 
     explicit pipe_base(std::string name, bool optional_pipe = false);
 
@@ -135,11 +224,15 @@ public:
         kangsw::ptr_proxy<bool> selective_input;
         kangsw::ptr_proxy<bool> selective_output;
         kangsw::ptr_proxy<bool> is_optional;
+        kangsw::ptr_proxy<bool> stateless;
+        kangsw::ptr_proxy<bool> lazy_construction;
     };
     struct const_tweak_t {
         kangsw::ptr_proxy<const bool> selective_input;
         kangsw::ptr_proxy<const bool> selective_output;
         kangsw::ptr_proxy<const bool> is_optional;
+        kangsw::ptr_proxy<const bool> stateless;
+        kangsw::ptr_proxy<const bool> lazy_construction;
     };
 
     /** pre launch tweak 획득 */
@@ -203,6 +296,12 @@ public:
         void _prepare_next();
         void _propagate_fence_abortion(fence_index_t pending_fence, size_t output_link_index);
 
+        /**
+         * 활성 fence가 닫힌 pruning 구간에 속하면 구간 끝으로 건너뜁니다.
+         * cached_input_의 락을 잡은 상태에서 호출해야 합니다.
+         */
+        void _skip_pruned_fences();
+
     private:
         // clang-format off
         enum class input_link_state { none, valid, discarded };
@@ -215,6 +314,9 @@ public:
         std::vector<input_link_state> ready_conds_;
         std::atomic<fence_index_t> active_input_fence_ = fence_index_t::none;
         std::shared_ptr<base_shared_context> active_input_fence_object_;
+
+        /** 입력이 도달하지 않는 fence 구간 [begin, end). 열린 구간의 end는 최대값입니다. */
+        std::vector<std::pair<fence_index_t, fence_index_t>> pruned_windows_;
     };
 
     class alignas(64) executor_slot {
@@ -228,16 +330,18 @@ public:
             , index_(index)
         {
             context_._internal__set_option(options);
+            if (executor_) { executor_->set_workers_ref(owner.ref_workers_); }
         }
 
     public: // 실행 문맥 관련
-        executor_base* executor() const { return executor_.get(); }
+        executor_base* executor() const { return executor_ ? executor_.get() : owner_.shared_executor_.get(); }
         execution_context const& context_read() const { return context_; }
         execution_context& context_write() { return context_; }
         fence_index_t fence_index() const { return fence_index_; }
         bool _is_executor_busy() const { return fence_index_ != fence_index_t::none; }
-        bool _is_output_order() const { return index_ == owner_._pending_output_slot_index(); }
+        bool _is_output_order() const { return launch_order() == owner_.output_exec_slot_.load(std::memory_order_relaxed); }
         bool _is_busy() const { return _is_executor_busy() || busy_flag_.test(); }
+        size_t launch_order() const { return launch_order_.load(std::memory_order_relaxed); }
         auto latest_exec_result() const { return latest_execution_result_.load(std::memory_order_relaxed); }
 
         /**
@@ -250,12 +354,22 @@ public:
             std::shared_ptr<base_shared_context> fence_obj;
             fence_index_t fence_index;
             std::any input;
+            size_t launch_order;
         };
         void _launch_async(launch_args_t arg);
         kangsw::timer_thread_pool& workers();
 
+        /**
+         * 실행기 인스턴스가 아직 없다면 생성하고 warm-up을 수행합니다.
+         * stateless 파이프에서는 공유 실행기를 한 번만 생성합니다.
+         *
+         * @return 이번 호출에서 실행기를 생성했다면 true
+         */
+        bool _ensure_executor();
+
     private:
         void _swap_exec_context() { context_._swap_data_buff(); }
+        void _stamp(fence_stamp::time_point fence_stamp::*field);
 
     private: // 단계별로 등록되는 콜백 목록
         /**
@@ -307,6 +421,7 @@ public:
         std::optional<execution_context::timer_scope_indicator> timer_scope_link_;
 
         size_t index_;
+        std::atomic_size_t launch_order_ = -1; // 출력 순서를 결정하는 실행 번호
         std::atomic_flag busy_flag_;
 
         mutable std::pair<std::condition_variable, std::mutex> done_notify_;
@@ -319,6 +434,7 @@ public:
     struct output_link_desc {
         output_link_adapter_type handler;
         pipe_base* pipe;
+        interned_name label; // 링크 타이머 이름 ":: [대상 파이프]". 연결 시 한 번만 생성합니다.
     };
 
 public:
@@ -338,8 +454,15 @@ public:
     /** 입력 가능 상태인지 확인 */
     bool can_submit_input_direct() const { return !_active_exec_slot()._is_executor_busy(); }
     bool is_paused() const { return paused_.load(std::memory_order_relaxed); }
-    void pause() { paused_.store(true, std::memory_order_relaxed); }
-    void unpause() { paused_.store(false, std::memory_order_relaxed); }
+
+    /**
+     * 파이프를 일시 정지합니다.
+     * 시동된 상태라면, 이 파이프와 이 파이프에만 의존하는 하위 그래프 전체를 활성 토폴로지에서 제외합니다.
+     * 제외된 동안 상류 링크는 fence 단위의 abort 전파 없이 해당 fence를 건너뜁니다.
+     * 하위 그래프가 외부 파이프로 출력한다면 제외하지 않고 기존처럼 fence마다 abort를 전파합니다.
+     */
+    void pause();
+    void unpause();
     bool recently_aborted() const { return recently_input_aborted_.load(std::memory_order::relaxed); }
     bool wait_active_slot_idle(std::chrono::milliseconds timeout) const { return _active_exec_slot()._wait_ready(timeout); }
 
@@ -357,6 +480,34 @@ public:
     }
     auto output_latency() const { return latest_output_latency_.load(std::memory_order_relaxed); }
 
+    /**
+     * 시동 이후의 시간 분포. 여러 사용자가 공유하므로, 일정 구간의 분포는 reset_histograms() 대신 두 시점의 snapshot() 차이로 구합니다.
+     */
+    auto& histogram(pipe_histogram_t kind) const { return histograms_[static_cast<size_t>(kind)]; }
+    void reset_histograms() { for (auto& hist : histograms_) { hist.reset(); } }
+
+    /**
+     * 타이머와 디버그 데이터를 기록할 fence의 간격을 지정합니다. fence n개 중 하나만 기록하고 게시하며, 0이면 기록하지 않습니다.
+     * 시동 이후에도 변경할 수 있습니다. 인터벌, 지연, 히스토그램 등의 지표는 샘플링과 무관하게 모든 fence에서 측정합니다.
+     */
+    size_t instrument_sampling() const { return sampling_interval_.load(std::memory_order_relaxed); }
+    void set_instrument_sampling(size_t interval) { sampling_interval_.store(interval, std::memory_order_relaxed); }
+
+    /**
+     * 디버그 데이터 구독을 관리합니다. 구독 모드에서는 구독한 키의 값만 생성 및 기록하며, 나머지 키는 이름만 기록합니다.
+     * 구독 모드가 아니라면 구독 여부와 무관하게 모든 값을 기록합니다. 시동 이후에도 변경할 수 있으며, 다음 fence부터 적용됩니다.
+     * 구독은 키별로 계수되므로, 여러 소비자가 같은 키를 구독했다면 모두 해제한 뒤에야 기록을 중단합니다.
+     */
+    void set_debug_data_gated(bool gated);
+    bool is_debug_data_gated() const { return debug_gated_.load(std::memory_order_relaxed); }
+    void subscribe_debug_data(std::string_view key);
+    void unsubscribe_debug_data(std::string_view key);
+    bool is_debug_data_subscribed(std::string_view key) const;
+
+    /** 시동 이후 모든 실행기가 실행에 소비한 누적 시간과 실행 횟수 */
+    auto total_busy_time() const { return std::chrono::nanoseconds(total_busy_ns_.load(std::memory_order_relaxed)); }
+    size_t num_executions() const { return num_executions_.load(std::memory_order_relaxed); }
+
     /** 옵션 변경 후 호출, mark dirty */
     void mark_dirty();
 
@@ -365,9 +516,32 @@ public:
     template <typename Shared_, typename PrevOut_, typename NextIn_, typename Fn_>
     void connect_output_to(pipe_base& other, Fn_&&);
 
-    /** 파이프라인을 시동합니다. */
+    /** 파이프라인을 시동합니다. lazy_construction이 지정되지 않았다면 모든 실행기를 즉시 생성합니다. */
     void launch(size_t num_executors, std::function<std::unique_ptr<executor_base>()>&& factory);
 
+    /**
+     * 실행기 없이 슬롯만 생성해 파이프를 시동합니다.
+     * 실행기 인스턴스는 _construct_executor()를 통해, 또는 지연 생성 모드에서 첫 실행 시 생성됩니다.
+     * 팩토리는 여러 스레드에서 동시에 호출될 수 있습니다.
+     */
+    void _launch_slots(size_t num_executors, std::function<std::unique_ptr<executor_base>()>&& factory);
+
+    /** 생성해야 하는 실행기 인스턴스의 개수. stateless 파이프는 하나의 인스턴스만 갖습니다. */
+    size_t _num_executor_instances() const { return mode_stateless_ ? 1 : executor_slots_.size(); }
+
+    /** index번째 실행기 인스턴스를 생성합니다. 서로 다른 index에 대해 동시에 호출할 수 있습니다. */
+    void _construct_executor(size_t index) { executor_slots_.at(index)->_ensure_executor(); }
+
+    /** 입력 슬롯. 상류 파이프를 거치지 않고 _submit_input()을 호출해 입력 경로만 측정하는 등, 내부 검증 용도로만 사용합니다. */
+    input_slot_t& _input_slot() { return input_slot_; }
+
+    /**
+     * 시동 시 각 실행기에 공급할 warm-up 입력을 지정합니다. launch() 이전에 호출해야 합니다.
+     * 각 실행기는 시동 직후 주어진 입력으로 num_iterations 회 실행되며, 그 출력과 실행 기록은 버려집니다.
+     * 지연 생성 모드에서는 실행기가 생성되는 첫 fence에서 warm-up하며, 그 fence는 지연 지표에서 제외됩니다.
+     */
+    void set_warm_up_input(std::any sample, size_t num_iterations = 1);
+
     /** launch의 편의성 래퍼입니다. */
     template <typename Fn_, typename... Args_>
     void launch_by(size_t num_executors, Fn_&& factory, Args_&&... args);
@@ -391,25 +565,99 @@ private:
     /** 출력이 완료된 슬롯에서 호출합니다. 다음 슬롯을 입력 활성화 */
     void _rotate_output_order(executor_slot* ref);
 
+    /** 실행기를 warm-up 입력으로 실행합니다. 실행 기록은 지표에 포함되지 않습니다. */
+    void _warm_up_executor(executor_base& exec, execution_context& context);
+
     /** 다음 입력 슬롯을 활성화. */
     size_t _rotate_slot() { return active_exec_slot_.fetch_add(1); }
 
     /** 출력할 차례가 된 실행 슬롯 반환 */
-    size_t _pending_output_slot_index() const { return output_exec_slot_.load(std::memory_order_relaxed) % executor_slots_.size(); }
+    size_t _pending_output_slot_index() const;
 
 public:
     void _set_thread_pool_reference(kangsw::timer_thread_pool* ref) { ref_workers_ = ref; }
     executor_slot const& _active_exec_slot() const { return *executor_slots_[_slot_active()]; }
-    size_t _slot_active() const { return active_exec_slot_.load() % executor_slots_.size(); }
-    void _refresh_interval_timer();
-    void _update_latest_latency(system_clock::time_point launched);
+    size_t _slot_active() const;
+    void _refresh_interval_timer(bool record_histogram = true);
+    void _update_latest_latency(clock::time_point launched);
+    void _accumulate_busy_time(clock::duration elapsed);
     bool _is_selective_input() const { return mode_selectie_input_; }
     bool _is_selective_output() const { return mode_selective_output_; }
+    bool _is_stateless() const { return mode_stateless_; }
+    std::shared_ptr<execution_context::debug_filter_type const> _debug_filter() const;
+    std::shared_ptr<execution_context::debug_filter_type const> _make_debug_filter() const; // debug_filter_lock_ 보유 상태에서 호출
+    bool _is_sampled_fence(fence_index_t fence) const
+    {
+        auto interval = instrument_sampling();
+        return interval != 0 && static_cast<size_t>(fence) % interval == 0;
+    }
     void _update_abort_received(bool abort) { recently_input_aborted_.store(abort, std::memory_order::relaxed); }
 
+    /** 상류 링크가 주어진 fence를 이 파이프로 전달하지 않아도 되는지 확인합니다. O(1) */
+    bool _is_pruned_fence(fence_index_t fence) const;
+
+    /** 일시 정지된 파이프의 하위 그래프를 활성 토폴로지에서 제외합니다. 시동 이후에만 유효합니다. */
+    void _prune_paused_subgraph();
+
+public:
+    /**
+     * 출력 메모이제이션을 활성화합니다. 시동 전에만 호출할 수 있습니다.
+     * 같은 입력과 같은 옵션 세대(파이프 옵션과 공유 옵션)로 실행한 최근 출력이 캐시에 있다면 실행기를 건너뛰고, 캐시된 출력을 그대로 출력 링크에 전달합니다.
+     * 해시는 후보를 찾는 데만 사용하며, 캐시는 입력의 사본을 함께 보관해 input_equal로 비교하므로 해시 충돌이 다른 입력의 출력을 반환하지 않습니다.
+     *
+     * @param capacity LRU 캐시에 보관할 최대 출력 개수
+     * @param input_hasher 입력 데이터의 해시 함수
+     * @param input_equal 두 입력 데이터가 같은지 비교하는 함수
+     */
+    void enable_memoization(
+      size_t capacity,
+      std::function<size_t(std::any const&)> input_hasher,
+      std::function<bool(std::any const&, std::any const&)> input_equal);
+    bool is_memoization_enabled() const { return memo_ != nullptr; }
+    size_t memoization_hits() const { return memo_ ? memo_->num_hit.load(std::memory_order_relaxed) : 0; }
+    size_t memoization_misses() const { return memo_ ? memo_->num_miss.load(std::memory_order_relaxed) : 0; }
+    double memoization_hit_rate() const;
+
+    /**
+     * 재실행을 위해 마지막 출력을 보관합니다. 입력 링크가 없는 파이프는 마지막 입력과 fence 객체도 보관합니다.
+     * 시동 전에만 호출할 수 있습니다.
+     */
+    void enable_replay();
+    bool is_replay_enabled() const { return replay_ != nullptr; }
+
+    /** 이 파이프가 fence의 stamps()[index]에 통과 시각을 기록하도록 합니다. */
+    void _enable_fence_stamps(size_t index) { stamp_index_ = index; }
+
+    /** 파이프라인 안에서의 인덱스를 지정합니다. fence에 묶인 옵션 스냅샷을 찾는 데 사용합니다. */
+    void _set_pipeline_index(size_t index) { pipeline_index_ = index; }
+
+    /** 옵션 세대를 올리지 않고, 모든 실행 문맥에 옵션이 변경되었음을 알립니다. 세대는 호출자가 이미 올린 경우에 사용합니다. */
+    void _mark_contexts_dirty();
+
+    /** 실행이 끝날 때마다 타이머 스코프 기록을 전달할 기록기를 지정합니다. 시동 전에만 호출할 수 있습니다. */
+    void set_trace_recorder(std::shared_ptr<trace_recorder> recorder);
+
+    /** 보관된 마지막 입력과 fence 객체, 그 fence의 인덱스를 반환합니다. */
+    std::tuple<std::any, std::shared_ptr<base_shared_context>, fence_index_t> _replay_source() const;
+
 private:
     kangsw::timer_thread_pool& _thread_pool() const { return *ref_workers_; }
     executor_slot& _active_exec_slot() { return *executor_slots_[_slot_active()]; }
+    pipe_base& _front_pipe();
+    fence_index_t _front_fence();
+    void _restore_pruned_subgraph();
+
+    struct memo_key_t;
+    memo_key_t _memo_key(std::any const& input, size_t options_generation, size_t shared_generation) const;
+    std::optional<pipe_error> _memo_fetch(memo_key_t const& key, std::any const& input, std::any& output);
+    void _memo_store(memo_key_t const& key, std::any const& input, pipe_error result, std::any const& output);
+
+    /**
+     * source fence에서 보관한 출력이 있다면 반환하고, 보관된 출력이 fence에도 유효하다고 기록합니다.
+     * 이 파이프가 source fence에서 실행되지 않았다면(abort, 일시 정지 등) 보관된 출력은 다른 fence의 것이므로 반환하지 않습니다.
+     */
+    std::optional<pipe_error> _fetch_replay_output(std::any& output, fence_index_t source, fence_index_t fence);
+    void _retain_replay_output(pipe_error result, std::any const& output, fence_index_t fence);
 
 private:
     pipe_id_t const id_ = pipe_id_gen::generate();
@@ -420,8 +668,15 @@ private:
 
     /** 실행기의 개수는 파이프라인 시동 이후 변하지 않아야 합니다. */
     std::vector<std::unique_ptr<executor_slot>> executor_slots_;
-    std::atomic_size_t active_exec_slot_; // idle 슬롯 선택(반드시 순차적)
-    std::atomic_size_t output_exec_slot_; // 출력 슬롯 선택
+    std::atomic_size_t active_exec_slot_; // 실행 순서 발급(stateful인 경우 idle 슬롯 선택, 반드시 순차적)
+    std::atomic_size_t output_exec_slot_; // 출력할 실행 순서
+
+    /** stateless 모드에서 모든 슬롯이 공유하는 실행기 인스턴스 */
+    std::unique_ptr<executor_base> shared_executor_;
+    std::once_flag shared_executor_once_;
+
+    /** 실행기 팩토리. 지연 생성 모드를 위해 시동 이후에도 보관합니다. */
+    std::function<std::unique_ptr<executor_base>()> executor_factory_;
 
     /** 모든 입출력 링크는 파이프라인 시동 이후 변하지 않아야 합니다. */
     std::vector<input_link_desc> input_links_;
@@ -430,24 +685,100 @@ private:
     /** 가장 최근에 실행된 execution 정보 */
     std::atomic<execution_context const*> latest_exec_context_;
     std::atomic<fence_index_t> latest_output_fence_;
-    std::atomic<system_clock::duration> latest_interval_;
-    std::atomic<system_clock::time_point> latest_output_tp_ = system_clock::now();
-    std::atomic<system_clock::duration> latest_output_latency_;
+    std::atomic<clock::duration> latest_interval_;
+    std::atomic<clock::time_point> latest_output_tp_ = clock::now();
+    std::atomic<clock::duration> latest_output_latency_;
+    std::array<latency_histogram, static_cast<size_t>(pipe_histogram_t::_count)> histograms_;
+    std::atomic_int64_t total_busy_ns_ = 0;
+    std::atomic_size_t num_executions_ = 0;
+    std::atomic_size_t sampling_interval_ = 1;
+
+    /** 디버그 데이터 구독 상태. 실행 스레드는 fence마다 필터 스냅샷을 한 번 읽습니다. */
+    mutable kangsw::spinlock debug_filter_lock_;
+    std::unordered_map<kangsw::hash_index, size_t> debug_subscriptions_; // 키별 구독 수
+    std::shared_ptr<execution_context::debug_filter_type const> debug_filter_;
+    std::atomic_bool debug_gated_ = false;
 
     std::vector<output_handler_type> output_handlers_;
 
     kangsw::timer_thread_pool* ref_workers_ = nullptr;
     std::unique_ptr<option_base> executor_options_;
 
+    /** 출력 메모이제이션의 키. 실행 시 참조한 두 옵션 세대와, 이들과 입력 해시를 조합한 해시입니다. */
+    struct memo_key_t {
+        size_t hash;
+        size_t options_generation;
+        size_t shared_generation;
+    };
+
+    /** 출력 메모이제이션. 입력과 실행 시 참조한 옵션 세대가 같은 최근 출력을 보관하는 LRU 캐시 */
+    struct memoization_t {
+        struct entry_type {
+            memo_key_t key;
+            std::any input;
+            pipe_error result;
+            std::any output;
+        };
+        using entry_iterator = std::list<entry_type>::iterator;
+
+        size_t capacity;
+        std::function<size_t(std::any const&)> hasher;
+        std::function<bool(std::any const&, std::any const&)> equal;
+
+        std::mutex lock;
+        std::list<entry_type> entries; // 최근 사용 순서. 앞쪽이 최신
+        std::unordered_multimap<size_t, entry_iterator> index;
+
+        std::atomic_size_t num_hit = 0;
+        std::atomic_size_t num_miss = 0;
+
+        /** 키와 입력이 모두 같은 항목. 잠금을 잡은 상태에서 호출해야 합니다. */
+        std::optional<entry_iterator> find(memo_key_t const& key, std::any const& input);
+    };
+    std::unique_ptr<memoization_t> memo_;
+
+    /** 재실행을 위해 보관하는 마지막 입출력과, 각각이 속한 fence */
+    struct replay_cache_t {
+        mutable std::mutex lock;
+        std::any input;
+        std::shared_ptr<base_shared_context> fence_object;
+        fence_index_t input_fence = fence_index_t::none;
+        std::optional<pipe_error> result;
+        std::any output;
+        fence_index_t output_fence = fence_index_t::none;
+    };
+    std::unique_ptr<replay_cache_t> replay_;
+
+    /** 실행 타임라인 기록기 */
+    std::shared_ptr<trace_recorder> trace_;
+
+    /** fence 통과 시각을 기록할 인덱스. 비활성화 상태에서는 -1입니다. */
+    size_t stamp_index_ = ~size_t{};
+
+    /** 파이프라인 안에서의 인덱스. 파이프라인에 속하지 않았다면 -1입니다. */
+    size_t pipeline_index_ = ~size_t{};
+
+    /** 시동 시 실행기 warm-up에 사용할 입력 */
+    std::any warm_up_input_;
+    size_t num_warm_up_iterations_ = 0;
+
     /** 일시 정지 처리 */
     std::atomic_bool paused_;
 
+    /** 일시 정지로 제외된 하위 그래프. 상류 링크는 [prune_begin_, prune_end_) 구간의 fence를 건너뜁니다. */
+    std::mutex prune_lock_;
+    std::vector<pipe_base*> pruned_subgraph_;
+    std::atomic<fence_index_t> prune_begin_ = fence_index_t::none;
+    std::atomic<fence_index_t> prune_end_ = fence_index_t::none;
+
     /** 상태 플래그 */
     std::atomic_bool recently_input_aborted_;
 
     /** 설정 플래그 */
     bool mode_selective_output_ = false;
     bool mode_selectie_input_ = false;
+    bool mode_stateless_ = false;
+    bool mode_lazy_construction_ = false;
 
     //---GUARD--//
     kangsw::destruction_guard destruction_guard_;
@@ -574,7 +905,8 @@ public:
     }
 
 public:
-    pipe_error invoke__(std::any& input, std::any& output) override
+    using executor_base::invoke__;
+    pipe_error invoke__(execution_context& ec, std::any& input, std::any& output) override
     {
         if (input.type() != typeid(input_type)) {
             throw pipe_input_exception("input type not match");
@@ -583,7 +915,6 @@ public:
             output.emplace<output_type>();
         }
 
-        auto& ec = *context_;
         auto& in = std::any_cast<input_type&>(input);
         auto& out = std::any_cast<output_type&>(output);
 
@@ -602,7 +933,7 @@ public:
         else if constexpr (is_invocable_r_v<OUT, executor_type, EC, INR>       ) { out = exec_(ec, in); return ok; }
         else if constexpr (is_invocable_r_v<OUT, executor_type, INR>           ) { out = exec_(in); return ok; }
         else if constexpr (is_invocable_r_v<void, executor_type, INR, OUTR>           ) { exec_(in, out); return ok; }
-        else { return std::invoke( &executor_type::invoke, &exec_, *context_, in, out); }
+        else { return std::invoke( &executor_type::invoke, &exec_, ec, in, out); }
         // clang-format on
     }
 
@@ -625,6 +956,150 @@ decltype(auto) make_executor(Args_&&... args)
     return std::make_unique<executor<Exec_>>(std::forward<Args_>(args)...);
 }
 
+/**
+ * 하나의 입력을 여러 조각으로 분할해 스레드 풀에서 동시에 처리한 뒤, 하나의 출력으로 병합하는 실행기입니다.
+ * 조각 단위의 병렬 처리는 파이프의 타이머에 하나의 논리적 실행으로 기록됩니다.
+ *
+ * Exec_ 형식은 다음을 정의해야 합니다.
+ *
+ *  input_type, output_type, chunk_input_type, chunk_output_type\n
+ *  void scatter(execution_context&, input_type const&, std::vector<chunk_input_type>&)\n
+ *  pipe_error invoke_chunk(chunk_input_type const&, chunk_output_type&) const\n
+ *  pipe_error gather(execution_context&, std::vector<chunk_output_type>&, output_type&)\n
+ *
+ * invoke_chunk는 여러 스레드에서 동시에 호출되므로, 실행기의 상태를 변경해서는 안 됩니다.
+ * 조각 버퍼는 매 실행마다 새로 할당되므로, scatter와 gather가 상태를 갖지 않는다면 stateless 파이프에도 사용할 수 있습니다.
+ * invoke_chunk와 gather는 pipe_error 대신 void를 반환할 수 있습니다.
+ */
+template <typename Exec_>
+class scatter_gather_executor final : public detail::executor_base {
+public:
+    using executor_type = Exec_;
+    using input_type = typename executor_type::input_type;
+    using output_type = typename executor_type::output_type;
+    using chunk_input_type = typename executor_type::chunk_input_type;
+    using chunk_output_type = typename executor_type::chunk_output_type;
+
+    static_assert(std::is_default_constructible_v<output_type>);
+    static_assert(std::is_default_constructible_v<chunk_output_type>);
+
+public:
+    template <typename... Ty_>
+    scatter_gather_executor(Ty_&&... args)
+        : exec_(std::forward<Ty_>(args)...)
+    {
+    }
+
+public:
+    using executor_base::invoke__;
+    pipe_error invoke__(execution_context& ec, std::any& input, std::any& output) override
+    {
+        if (input.type() != typeid(input_type)) {
+            throw pipe_input_exception("input type not match");
+        }
+        if (output.type() != typeid(output_type)) {
+            output.emplace<output_type>();
+        }
+
+        auto& in = std::any_cast<input_type&>(input);
+        auto& out = std::any_cast<output_type&>(output);
+
+        auto dispatch = std::make_shared<chunk_dispatch_t>(this);
+        exec_.scatter(ec, in, dispatch->chunk_inputs);
+        dispatch->chunk_outputs.resize(dispatch->chunk_inputs.size());
+
+        auto result = _run_chunks(dispatch);
+        if (result > pipe_error::warning) { return result; }
+
+        if constexpr (std::is_void_v<decltype(exec_.gather(ec, dispatch->chunk_outputs, out))>) {
+            exec_.gather(ec, dispatch->chunk_outputs, out);
+            return result;
+        } else {
+            return std::max(result, exec_.gather(ec, dispatch->chunk_outputs, out));
+        }
+    }
+
+private:
+    /** 한 번의 실행 동안 호출 스레드와 작업자 스레드가 공유하는 상태입니다. */
+    struct chunk_dispatch_t {
+        scatter_gather_executor* self;
+        std::vector<chunk_input_type> chunk_inputs = {};
+        std::vector<chunk_output_type> chunk_outputs = {};
+        std::atomic_size_t next_chunk = 0;
+        std::atomic_size_t num_active = 0;
+        std::atomic<pipe_error> result = pipe_error::ok;
+        std::atomic_flag has_exception = ATOMIC_FLAG_INIT;
+        std::exception_ptr exception = nullptr; // 처음 발생한 예외. 호출 스레드에서 다시 던집니다.
+    };
+
+    pipe_error _run_chunks(std::shared_ptr<chunk_dispatch_t> const& dispatch)
+    {
+        auto const num_chunks = dispatch->chunk_inputs.size();
+
+        // 호출 스레드 또한 조각을 처리하므로, 나머지 조각의 개수만큼만 작업을 발행합니다.
+        for (size_t i = 1; workers_ && i < num_chunks; ++i) {
+            workers_->add_task(&scatter_gather_executor::_process_chunks, dispatch);
+        }
+
+        _process_chunks(dispatch);
+
+        // 모든 조각이 할당된 후에는, 조각을 처리 중인 작업자만 기다립니다.
+        // 아직 시작되지 않은 작업은 할당할 조각이 없으므로 즉시 반환됩니다.
+        while (dispatch->num_active.load() != 0) { std::this_thread::yield(); }
+        if (dispatch->exception) { std::rethrow_exception(dispatch->exception); }
+        return dispatch->result.load();
+    }
+
+    static void _process_chunks(std::shared_ptr<chunk_dispatch_t> const& dispatch)
+    {
+        auto& d = *dispatch;
+        d.num_active.fetch_add(1);
+
+        // 예외가 발생하더라도 호출 스레드가 영원히 대기하지 않도록, 반드시 활성 카운터를 감소시킵니다.
+        struct active_guard {
+            chunk_dispatch_t& d;
+            ~active_guard() { d.num_active.fetch_sub(1); }
+        } _guard{d};
+
+        try {
+            _process_chunks_impl(d);
+        } catch (...) {
+            // 남은 조각은 더 이상 할당하지 않습니다.
+            d.next_chunk.store(d.chunk_inputs.size());
+            if (!d.has_exception.test_and_set()) { d.exception = std::current_exception(); }
+        }
+    }
+
+    static void _process_chunks_impl(chunk_dispatch_t& d)
+    {
+        for (size_t index; (index = d.next_chunk.fetch_add(1)) < d.chunk_inputs.size();) {
+            auto& exec = std::as_const(d.self->exec_);
+            auto& chunk_in = d.chunk_inputs[index];
+            auto& chunk_out = d.chunk_outputs[index];
+
+            auto res = pipe_error::ok;
+            if constexpr (std::is_void_v<decltype(exec.invoke_chunk(chunk_in, chunk_out))>) {
+                exec.invoke_chunk(chunk_in, chunk_out);
+            } else {
+                res = exec.invoke_chunk(chunk_in, chunk_out);
+            }
+
+            for (auto prev = d.result.load(); prev < res && !d.result.compare_exchange_weak(prev, res);) {}
+        }
+    }
+
+    void const* _get_actual_executor() const override { return &exec_; }
+
+private:
+    executor_type exec_;
+};
+
+template <typename Exec_, typename... Args_>
+decltype(auto) make_scatter_gather_executor(Args_&&... args)
+{
+    return std::make_unique<scatter_gather_executor<Exec_>>(std::forward<Args_>(args)...);
+}
+
 template <typename Exec_, typename... Args_>
 decltype(auto) factory(Args_&&... args)
 {
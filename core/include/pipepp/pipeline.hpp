@@ -1,14 +1,25 @@
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <typeinfo>
+#include <vector>
 #include "kangsw/helpers/misc.hxx"
 #include "kangsw/thread/thread_pool.hxx"
 #include "nlohmann/json_fwd.hpp"
 #include "pipepp/pipe.hpp"
 
 namespace pipepp {
+/** 옵션을 바이트열로 내보내거나 불러올 때의 직렬화 형식 */
+enum class option_format {
+    json,
+    cbor,
+    msgpack,
+};
+
 namespace detail {
 
 class pipeline_base : public std::enable_shared_from_this<pipeline_base> {
@@ -28,21 +39,88 @@ public:
     auto& _thread_pool() { return workers_; }
     void sync();
 
-    // launcher
-    void launch();
+    /**
+     * 파이프라인을 시동합니다.
+     * construct_in_parallel이 true이면 모든 파이프의 실행기를 작업자 스레드 풀에서 병렬로 생성하므로, 팩토리는 스레드 안전해야 합니다.
+     * 실행기 생성 중 발생한 예외는 모두 수집되어 하나의 pipe_exception으로 던져집니다.
+     */
+    void launch(bool construct_in_parallel = true);
+
+    /**
+     * 시동 시 모든 파이프가 재실행을 위해 마지막 입출력을 보관하도록 설정합니다.
+     * 출력이 fence마다 복사되므로, 옵션 튜닝 등 필요한 경우에만 활성화합니다.
+     */
+    void enable_replay();
+
+    /**
+     * 마지막 입력으로 주어진 파이프와 그 하위 그래프만 다시 실행합니다.
+     * 나머지 파이프는 실행기를 건너뛰고 보관된 마지막 출력을 링크에 전달하며, 출력 핸들러도 호출하지 않습니다.
+     * 재실행은 새 fence로 공급되며, shared data는 마지막 입력의 fence에서 복사한 뒤 reload()됩니다.
+     *
+     * @return 재실행이 비활성화되었거나, 보관된 입력이 없거나, 파이프라인이 가동 중이거나, shared data를 복사할 수 없으면 false
+     */
+    bool replay(pipe_id_t pipe);
+
+    /**
+     * 시동 시 모든 파이프에 실행 타임라인 기록기를 연결합니다.
+     * 기록은 기록기의 start()를 호출한 뒤부터 수집됩니다.
+     */
+    void set_trace_recorder(std::shared_ptr<trace_recorder> recorder);
+
+    /**
+     * 시동 시 모든 파이프가 fence마다 통과 시각을 기록하도록 하고, 완료된 fence를 임계 경로 분석기에 전달합니다.
+     * 완료된 fence는 shared context가 재사용될 때, 또는 sync() 호출 시 전달됩니다.
+     */
+    void set_critical_path_analyzer(std::shared_ptr<critical_path_analyzer> analyzer);
 
 public:
     auto& options() const { return *global_options_; }
     auto& options() { return *global_options_; }
 
+    /**
+     * 옵션을 "___shared", "___pipes", "___suspended" 섹션으로 내보냅니다.
+     * option_blob 값은 옵션 섹션에 핸들로만 남고, 바이트열은 "___blobs" 섹션에 핸들별로 따로 담깁니다. 불러올 때는 바이트열을 다시 등록하고 핸들을 연결합니다.
+     */
     void export_options(nlohmann::json&);
     void import_options(nlohmann::json const&);
 
+    /**
+     * since_generation 이후 변경된 옵션만 export_options()와 같은 형식으로 내보냅니다. 변경이 없는 파이프는 생략합니다.
+     * 문서의 "___generation"에 내보낸 시점의 세대가 기록되며, 다음 호출에 그대로 전달하면 그 사이의 변경만 받을 수 있습니다.
+     * 결과는 import_options()와 swap_options()로 그대로 불러올 수 있습니다.
+     */
+    void export_options(nlohmann::json&, size_t since_generation);
+
+    /** 옵션을 주어진 형식의 바이트열로 내보냅니다. since_generation이 0이 아니라면 그 이후의 변경만 내보냅니다. */
+    std::vector<uint8_t> export_options(option_format format, size_t since_generation = 0);
+    void import_options(std::span<uint8_t const> in, option_format format);
+
+    /**
+     * import_options()와 같은 형식의 옵션을 검증한 뒤, 모든 파이프에 한 번에 적용합니다.
+     * 병합과 검증은 사본에서 수행하고, 모든 옵션의 잠금과 fence 발급 잠금을 잡은 상태로 옵션과 일시 정지 상태를 교체하므로 일부 파이프만 변경된 상태는 관찰되지 않습니다.
+     * 각 fence는 발급 시점의 옵션 스냅샷에 묶이므로(base_shared_context::option_generation()), 처리 중인 fence도 끝까지 교체 전의 옵션을 사용합니다.
+     * 검증에 실패한 항목이 있다면 아무것도 변경하지 않고 false를 반환하며, 사유를 error에 기록합니다.
+     */
+    bool swap_options(nlohmann::json const& in, std::string* error = nullptr);
+
+    /**
+     * 파이프 이름별 실행기 개수를 "___executors" 섹션으로 내보내거나 불러옵니다.
+     * 불러오기는 시동 전에만 가능하며, 목록에 없는 파이프는 생성 시 지정한 개수를 유지합니다.
+     */
+    void export_executor_counts(nlohmann::json&) const;
+    void import_executor_counts(nlohmann::json const&);
+
 protected:
     // shared data object allocator
     std::shared_ptr<base_shared_context> _fetch_shared();
     virtual std::shared_ptr<base_shared_context> _new_shared_object() = 0;
 
+    /** src의 shared data를 dst에 복사합니다. 복사할 수 없는 형식이라면 false를 반환합니다. */
+    virtual bool _copy_shared_object(base_shared_context& dst, base_shared_context const& src) = 0;
+
+private:
+    void _collect_fence_stamps(base_shared_context& fence);
+
 protected:
     std::vector<std::unique_ptr<pipe_base>> pipes_;
     std::vector<std::shared_ptr<base_shared_context>> fence_objects_;
@@ -52,6 +130,9 @@ protected:
     kangsw::timer_thread_pool workers_;
 
     std::vector<std::tuple<size_t, std::function<factory_return_type(void)>>> adapters_;
+    bool replay_enabled_ = false;
+    std::shared_ptr<trace_recorder> trace_recorder_;
+    std::shared_ptr<critical_path_analyzer> critical_path_;
 };
 
 class pipe_proxy_base {
@@ -107,6 +188,24 @@ public:
     // return latest output interval
     auto output_interval() const { return pipe().output_interval(); }
     auto output_latency() const { return pipe().output_latency(); }
+    auto total_busy_time() const { return pipe().total_busy_time(); }
+    size_t num_executions() const { return pipe().num_executions(); }
+
+    // time distributions; percentile p in [0, 100]
+    auto& histogram(pipe_histogram_t kind) const { return pipe().histogram(kind); }
+    auto percentile(pipe_histogram_t kind, double p) const { return pipe().histogram(kind).percentile(p); }
+    void reset_histograms() { pipe().reset_histograms(); }
+
+    // debug data subscription; when gated, only subscribed keys construct and store values
+    void set_debug_data_gated(bool gated) { pipe().set_debug_data_gated(gated); }
+    bool is_debug_data_gated() const { return pipe().is_debug_data_gated(); }
+    void subscribe_debug_data(std::string_view key) { pipe().subscribe_debug_data(key); }
+    void unsubscribe_debug_data(std::string_view key) { pipe().unsubscribe_debug_data(key); }
+    bool is_debug_data_subscribed(std::string_view key) const { return pipe().is_debug_data_subscribed(key); }
+
+    // record timers and debug data for 1 of every n fences; 0 disables recording
+    size_t instrument_sampling() const { return pipe().instrument_sampling(); }
+    void set_instrument_sampling(size_t interval) { pipe().set_instrument_sampling(interval); }
 
     // pause functionality
     bool is_paused() const { return pipe().is_paused(); }
@@ -117,6 +216,12 @@ public:
     // mark dirty
     void mark_option_dirty() { pipe().mark_dirty(); }
 
+    // memoization metrics
+    bool is_memoization_enabled() const { return pipe().is_memoization_enabled(); }
+    size_t memoization_hits() const { return pipe().memoization_hits(); }
+    size_t memoization_misses() const { return pipe().memoization_misses(); }
+    double memoization_hit_rate() const { return pipe().memoization_hit_rate(); }
+
     auto configure_tweaks() { return pipe().get_prelaunch_tweaks(); }
     auto tweaks() { return pipe().read_tweaks(); }
 
@@ -221,6 +326,36 @@ public:
     template <typename Fn_>
     pipe_proxy& add_output_handler(Fn_&& handler);
 
+    /**
+     * 파이프라인 시동 시 각 실행기를 주어진 입력으로 미리 실행합니다.
+     * 출력은 버려지며, 실행 시간 등의 지표에 포함되지 않습니다.
+     */
+    pipe_proxy& warm_up(input_type sample, size_t num_iterations = 1)
+    {
+        pipe().set_warm_up_input(std::move(sample), num_iterations);
+        return *this;
+    }
+
+    /**
+     * 출력 메모이제이션을 활성화합니다.
+     * hasher는 input_type const&를 받아 size_t 해시를 반환해야 합니다. 파이프 옵션과 공유 옵션의 세대는 자동으로 키에 포함됩니다.
+     * 캐시는 입력의 사본을 보관하고 equal로 비교하므로, 비교 연산자가 없는 입력 형식은 equal을 직접 지정해야 합니다.
+     * 실행기가 입력과 옵션 외의 상태에 의존한다면 사용하지 마십시오.
+     */
+    template <typename Hasher_, typename Equal_ = std::equal_to<input_type>>
+    pipe_proxy& enable_memoization(size_t capacity, Hasher_&& hasher, Equal_&& equal = {})
+    {
+        pipe().enable_memoization(
+          capacity,
+          [hasher = std::forward<Hasher_>(hasher)](std::any const& input) -> size_t {
+              return hasher(std::any_cast<input_type const&>(input));
+          },
+          [equal = std::forward<Equal_>(equal)](std::any const& a, std::any const& b) -> bool {
+              return equal(std::any_cast<input_type const&>(a), std::any_cast<input_type const&>(b));
+          });
+        return *this;
+    }
+
 private:
     std::shared_ptr<pipeline_type> _lock() const
     {
@@ -327,12 +462,32 @@ public:
     bool suply(
       input_type input, Fn_&& shared_data_init_func = [](auto&&) {})
     {
+        // 관찰자는 공급 직전에 호출되므로, 공급에 실패할 입력이 관찰되지 않도록 확인부터 공급까지를 직렬화합니다.
+        auto observer = suply_observer_.load(std::memory_order_acquire);
+        std::unique_lock observer_lock{suply_observer_lock_, std::defer_lock};
+        if (observer) {
+            observer_lock.lock();
+            if (!can_suply()) { return false; }
+        }
+
         auto shared = _fetch_shared();
         shared_data_init_func(static_cast<shared_data_type&>(*shared));
         shared->reload();
+        if (observer) { (*observer)(input, static_cast<shared_data_type const&>(*shared)); }
         return pipes_.front()->try_submit(std::move(input), std::move(shared));
     }
 
+    /**
+     * suply()로 공급되는 입력과 초기화된 shared data를 관찰합니다. 입력 기록 등에 사용합니다.
+     * 관찰자는 원자적으로 교체되므로 suply()와 동시에 호출할 수 있으나, 교체 직전에 시작된 suply()는 이전 관찰자를 호출할 수 있습니다.
+     * 관찰자가 설정된 동안 suply()는 직렬화되므로, 관찰자는 동시에 호출되지 않으며 관찰된 입력은 모두 공급됩니다.
+     */
+    using suply_observer_type = std::function<void(input_type const&, shared_data_type const&)>;
+    void set_suply_observer(suply_observer_type observer)
+    {
+        suply_observer_.store(observer ? std::make_shared<suply_observer_type const>(std::move(observer)) : nullptr, std::memory_order_release);
+    }
+
     bool wait_supliable(std::chrono::milliseconds timeout = std::chrono::milliseconds{10}) const
     {
         return !pipes_.front()->is_paused() && pipes_.front()->wait_active_slot_idle(timeout);
@@ -344,7 +499,19 @@ protected:
         return std::make_shared<shared_data_type>();
     }
 
+    bool _copy_shared_object(base_shared_context& dst, base_shared_context const& src) override
+    {
+        if constexpr (std::is_copy_assignable_v<shared_data_type>) {
+            static_cast<shared_data_type&>(dst) = static_cast<shared_data_type const&>(src);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
 private:
+    std::atomic<std::shared_ptr<suply_observer_type const>> suply_observer_;
+    std::mutex suply_observer_lock_;
 };
 
 static constexpr auto link_as_is = [](auto&& prev_out, auto&& next_in) { next_in = std::forward<decltype(prev_out)>(prev_out);  return true; };
@@ -65,26 +65,66 @@ using options = const detail::option_base;
     (__VA_ARGS__)
 #endif
 
-#define ___PIPEPP_ELAPSE_SCOPE(NAME)                                               \
-    constexpr kangsw::hash_pack ___PIPEPP_CONCAT(___TIMER_HASH_, __LINE__) = NAME; \
-    auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__) = ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(___PIPEPP_CONCAT(___TIMER_HASH_, __LINE__));
+/**
+ * 계측 매크로의 컴파일 타임 수준입니다. 빌드 시 PIPEPP_INSTRUMENTATION_LEVEL로 지정합니다.
+ *
+ * 0: 모든 PIPEPP_ELAPSE_*, PIPEPP_STORE_DEBUG_* 매크로가 아무 일도 하지 않습니다.
+ * 1: 타이머만 기록합니다.
+ * 2: 타이머와 디버그 데이터를 모두 기록합니다. (기본값)
+ *
+ * 비활성화된 매크로의 인자는 컴파일은 되지만 평가되지 않습니다.
+ * 활성화된 매크로도 실행 문맥이 기록 중이 아니라면(파이프의 샘플링 간격 밖의 fence), 인자를 평가하기 전에 건너뜁니다.
+ * 디버그 데이터의 값은 지연 평가되므로, 구독하지 않은 키의 값은 생성되지 않습니다.
+ */
+#ifndef PIPEPP_INSTRUMENTATION_LEVEL
+#define PIPEPP_INSTRUMENTATION_LEVEL 2
+#endif
 
-#define ___PIPEPP_ELAPSE_BLOCK(NAME)                                               \
-    constexpr kangsw::hash_pack ___PIPEPP_CONCAT(___TIMER_HASH_, __LINE__) = NAME; \
-    if (auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__) = ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(___PIPEPP_CONCAT(___TIMER_HASH_, __LINE__)); true)
+#define ___PIPEPP_DISCARD(...) \
+    if constexpr (false) { __VA_ARGS__; }
+
+/** 리터럴 이름을 정적 초기화 시점에 전역 이름 테이블에 등록하고, 실행 시에는 등록된 이름을 참조만 합니다. */
+#define ___PIPEPP_INTERNED_NAME(VAR, NAME) \
+    auto const& VAR = ::pipepp::detail::static_interned_name<NAME>
+
+#if PIPEPP_INSTRUMENTATION_LEVEL >= 1
+#define ___PIPEPP_ELAPSE_SCOPE(NAME)                                           \
+    ___PIPEPP_INTERNED_NAME(___PIPEPP_CONCAT(___TIMER_NAME_, __LINE__), NAME); \
+    auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__) = ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(___PIPEPP_CONCAT(___TIMER_NAME_, __LINE__));
+
+#define ___PIPEPP_ELAPSE_BLOCK(NAME)                                           \
+    ___PIPEPP_INTERNED_NAME(___PIPEPP_CONCAT(___TIMER_NAME_, __LINE__), NAME); \
+    if (auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__) = ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(___PIPEPP_CONCAT(___TIMER_NAME_, __LINE__)); true)
+
+#define ___PIPEPP_ELAPSE_SCOPE_DYNAMIC(NAME)                  \
+    auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__)          \
+      = ___call_PIPEPP_REGISTER_CONTEXT.is_recording()        \
+          ? ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(NAME) \
+          : ::pipepp::execution_context::timer_scope_indicator{};
+#else
+#define ___PIPEPP_ELAPSE_SCOPE(NAME) ___PIPEPP_DISCARD(kangsw::hash_pack{NAME})
+#define ___PIPEPP_ELAPSE_BLOCK(NAME) if (true)
+#define ___PIPEPP_ELAPSE_SCOPE_DYNAMIC(NAME) ___PIPEPP_DISCARD(___call_PIPEPP_REGISTER_CONTEXT.timer_scope(NAME))
+#endif
 
-#define ___PIPEPP_ELAPSE_SCOPE_DYNAMIC(NAME) \
-    auto ___PIPEPP_CONCAT(___TIMER_SCOPE_, __LINE__) = ___call_PIPEPP_REGISTER_CONTEXT.timer_scope(NAME);
+#if PIPEPP_INSTRUMENTATION_LEVEL >= 2
+#define ___PIPEPP_STORE_DEBUG_DATA(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, true)
 
-#define ___PIPEPP_STORE_DEBUG_DATA(NAME, VALUE)                                   \
-    constexpr kangsw::hash_pack ___PIPEPP_CONCAT(___DATA_HASH_, __LINE__) = NAME; \
-    ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(___PIPEPP_CONCAT(___DATA_HASH_, __LINE__), (VALUE));
+#define ___PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, COND)                                                                    \
+    if (___call_PIPEPP_REGISTER_CONTEXT.is_recording() && (COND)) {                                                           \
+        ___PIPEPP_INTERNED_NAME(___PIPEPP_CONCAT(___DATA_NAME_, __LINE__), NAME);                                             \
+        ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(___PIPEPP_CONCAT(___DATA_NAME_, __LINE__), [&] { return (VALUE); }); \
+    }
 
-#define ___PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, COND)                                                    \
-    if (COND) {                                                                                               \
-        constexpr kangsw::hash_pack ___PIPEPP_CONCAT(___DATA_HASH_, __LINE__) = NAME;                         \
-        ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(___PIPEPP_CONCAT(___DATA_HASH_, __LINE__), (VALUE)); \
+#define ___PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE)                                  \
+    if (___call_PIPEPP_REGISTER_CONTEXT.is_recording()) {                                \
+        ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(NAME, [&] { return (VALUE); }); \
     }
+#else
+#define ___PIPEPP_STORE_DEBUG_DATA(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE)
+#define ___PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, COND) ___PIPEPP_DISCARD((void)(COND), ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(NAME, (VALUE)))
+#define ___PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE) ___PIPEPP_DISCARD(___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(NAME, (VALUE)))
+#endif
 
 /**
  * Declares new pipeline option for scope and category.
@@ -103,9 +143,9 @@ using options = const detail::option_base;
 #define PIPEPP_ELAPSE_SCOPE(NAME) ___PIPEPP_ELAPSE_SCOPE(NAME)
 #define PIPEPP_ELAPSE_BLOCK(NAME) ___PIPEPP_ELAPSE_BLOCK(NAME)
 #define PIPEPP_ELAPSE_SCOPE_DYNAMIC(NAME) ___PIPEPP_ELAPSE_SCOPE_DYNAMIC(NAME)
-#define PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE) ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(NAME, (VALUE));
+#define PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, VALUE)
 #define PIPEPP_STORE_DEBUG_DATA(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA(NAME, VALUE)
-#define PIPEPP_STORE_DEBUG_DATA_DYNAMIC_STR(NAME, VALUE) ___call_PIPEPP_REGISTER_CONTEXT.store_debug_data(NAME, (std::stringstream{} << VALUE).str());
+#define PIPEPP_STORE_DEBUG_DATA_DYNAMIC_STR(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA_DYNAMIC(NAME, (std::stringstream{} << VALUE).str())
 #define PIPEPP_STORE_DEBUG_STR(NAME, VALUE) ___PIPEPP_STORE_DEBUG_DATA(NAME, (std::stringstream{} << VALUE).str())
 #define PIPEPP_CAPTURE_DEBUG_DATA(VALUE) ___PIPEPP_STORE_DEBUG_DATA(#VALUE, VALUE)
 #define PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, COND) ___PIPEPP_STORE_DEBUG_DATA_COND(NAME, VALUE, COND)
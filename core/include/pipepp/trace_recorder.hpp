@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "pipepp/pipe.hpp"
+
+namespace pipepp {
+/**
+ * 모든 파이프의 타이머 스코프 기록을 수집해 Chrome trace 형식(JSON)으로 내보냅니다.
+ * 내보낸 파일은 chrome://tracing 또는 Perfetto UI에서 열어, 스레드별 슬롯 동시성과 대기 구간을 확인할 수 있습니다.
+ *
+ * pipeline_base::set_trace_recorder()로 시동 전에 연결하며, start()와 stop() 사이에 완료된 실행만 기록됩니다.
+ */
+class trace_recorder {
+public:
+    using clock = execution_context_data::clock;
+
+    struct event_type {
+        std::string_view name;
+        pipe_id_t pipe;
+        size_t slot;
+        fence_index_t fence;
+        std::thread::id thread;
+        size_t level;
+        clock::time_point begin;
+        clock::duration elapsed;
+    };
+
+public:
+    void start();
+    void stop() { recording_.store(false, std::memory_order_relaxed); }
+    bool is_recording() const { return recording_.load(std::memory_order_relaxed); }
+
+    /** 수집된 이벤트를 모두 지웁니다. */
+    void clear();
+    size_t size() const;
+
+    /**
+     * 수집된 이벤트를 Chrome trace 형식으로 기록합니다.
+     * 각 실행의 최상위 스코프는 "파이프 이름[슬롯]"으로, 하위 스코프는 타이머 이름으로 표시되며 fence 번호는 인자로 기록됩니다.
+     */
+    void write_chrome_trace(std::ostream& os) const;
+
+public:
+    void _register_pipe(pipe_id_t id, std::string name);
+    void _record(pipe_id_t pipe, size_t slot, fence_index_t fence, execution_context_data const& data);
+
+private:
+    std::atomic_bool recording_ = false;
+    clock::time_point origin_ = clock::now();
+
+    mutable std::mutex lock_;
+    std::vector<event_type> events_;
+    std::unordered_map<pipe_id_t, std::string> pipe_names_;
+};
+
+} // namespace pipepp
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include "pipepp/critical_path.hpp"
+
+std::string_view pipepp::critical_path_analyzer::segment_name(segment_t segment)
+{
+    switch (segment) {
+        case segment_t::input_wait: return "Input Wait";
+        case segment_t::queue: return "Queue";
+        case segment_t::run: return "A. Executor Run Time";
+        case segment_t::output_wait: return "B. Await for output order";
+        case segment_t::link_wait: return "Link Wait";
+        default: return "";
+    }
+}
+
+size_t pipepp::critical_path_analyzer::num_fences() const
+{
+    std::lock_guard lock{lock_};
+    return num_fences_;
+}
+
+size_t pipepp::critical_path_analyzer::num_on_path(std::string_view pipe) const
+{
+    std::lock_guard lock{lock_};
+    auto it = std::ranges::find(names_, pipe);
+    return it == names_.end() ? 0 : stats_[it - names_.begin()].num_on_path;
+}
+
+std::vector<pipepp::critical_path_analyzer::entry_type> pipepp::critical_path_analyzer::report() const
+{
+    std::lock_guard lock{lock_};
+    std::vector<entry_type> entries;
+
+    for (size_t index = 0; index < stats_.size(); ++index) {
+        for (size_t seg = 0; seg < stats_[index].segments.size(); ++seg) {
+            auto& stat = stats_[index].segments[seg];
+            if (stat.num_bounding == 0 && stat.total.count() == 0) { continue; }
+            entries.push_back({names_[index], static_cast<segment_t>(seg), stat.num_bounding, stat.total});
+        }
+    }
+
+    std::ranges::sort(entries, [](entry_type const& a, entry_type const& b) {
+        return a.num_bounding != b.num_bounding ? a.num_bounding > b.num_bounding : a.total > b.total;
+    });
+    return entries;
+}
+
+void pipepp::critical_path_analyzer::reset()
+{
+    std::lock_guard lock{lock_};
+    std::ranges::fill(stats_, pipe_stat{});
+    num_fences_ = 0;
+}
+
+void pipepp::critical_path_analyzer::_set_topology(std::vector<std::string> names, std::vector<std::vector<size_t>> inputs)
+{
+    std::lock_guard lock{lock_};
+    names_ = std::move(names);
+    inputs_ = std::move(inputs);
+    stats_.assign(names_.size(), {});
+    num_fences_ = 0;
+
+    is_sink_.assign(names_.size(), true);
+    for (auto& pipe_inputs : inputs_) {
+        for (auto input : pipe_inputs) { is_sink_[input] = false; }
+    }
+}
+
+void pipepp::critical_path_analyzer::_add(base_shared_context const& fence)
+{
+    using namespace std::chrono;
+    constexpr auto npos = ~size_t{};
+
+    std::lock_guard lock{lock_};
+    auto stamps = fence.stamps();
+    if (stamps.size() != names_.size()) { return; }
+
+    // 출력 파이프가 없는 파이프 중 가장 늦게 끝난 파이프가 경로의 끝입니다.
+    size_t cursor = npos;
+    for (size_t index = 0; index < stamps.size(); ++index) {
+        if (!is_sink_[index] || !stamps[index].is_executed()) { continue; }
+        if (cursor == npos || stamps[index].linked > stamps[cursor].linked) { cursor = index; }
+    }
+    if (cursor == npos) { return; }
+
+    struct path_segment {
+        size_t pipe;
+        segment_t segment;
+        nanoseconds elapsed;
+    };
+    std::vector<path_segment> path;
+    auto push = [&](segment_t segment, fence_stamp::time_point from, fence_stamp::time_point to) {
+        path.push_back({cursor, segment, std::max(nanoseconds{}, duration_cast<nanoseconds>(to - from))});
+    };
+
+    auto link_end = stamps[cursor].linked;
+    for (size_t depth = 0; depth < stamps.size(); ++depth) {
+        auto& stamp = stamps[cursor];
+        push(segment_t::link_wait, stamp.ordered, link_end);
+        push(segment_t::output_wait, stamp.finished, stamp.ordered);
+        push(segment_t::run, stamp.started, stamp.finished);
+        push(segment_t::queue, stamp.enqueued, stamp.started);
+
+        // 입력 파이프 중 가장 늦게 출력한 파이프가 이 파이프의 시작을 결정합니다.
+        size_t pred = npos;
+        for (auto input : inputs_[cursor]) {
+            if (!stamps[input].is_executed()) { continue; }
+            if (pred == npos || stamps[input].ordered > stamps[pred].ordered) { pred = input; }
+        }
+
+        if (pred == npos) {
+            push(segment_t::input_wait, fence.launch_time_point(), stamp.enqueued);
+            break;
+        }
+
+        auto handoff = std::min(stamps[pred].linked, stamp.enqueued);
+        push(segment_t::input_wait, handoff, stamp.enqueued);
+        link_end = handoff, cursor = pred;
+    }
+
+    auto bounding = std::ranges::max_element(path, {}, &path_segment::elapsed);
+    stats_[bounding->pipe].segments[static_cast<size_t>(bounding->segment)].num_bounding++;
+
+    for (size_t prev_pipe = npos; auto& seg : path) {
+        stats_[seg.pipe].segments[static_cast<size_t>(seg.segment)].total += seg.elapsed;
+        if (seg.pipe != prev_pipe) { stats_[seg.pipe].num_on_path++, prev_pipe = seg.pipe; }
+    }
+    ++num_fences_;
+}
@@ -1,17 +1,88 @@
+#include <atomic>
 #include <mutex>
+#include <span>
 
 #include "kangsw/helpers/hash_index.hxx"
 #include "pipepp/execution_context.hpp"
+#include "pipepp/options.hpp"
 
-kangsw::safe_string_table& pipepp::string_pool()
+namespace {
+/**
+ * Ը  lock-free  ̸ ̺Դϴ.
+ *
+ *    ּҹ Žϸ, Ž ѵ ȿ      ũ   Ѿϴ.
+ * ԰   ʹ CAS    ä  Ƿ, ȸ  б⸸  ϵ   ʽϴ.
+ *   Ƿ, Ž    ٸ  Ͽ  ̸ ϴ.
+ */
+struct intern_entry {
+    kangsw::hash_index hash;
+    std::string name;
+};
+
+using intern_slot = std::atomic<intern_entry const*>;
+static_assert(intern_slot::is_always_lock_free);
+
+struct intern_block {
+    std::span<intern_slot> slots; // ũ ׻ 2 ŵ
+    std::atomic<intern_block*> next = nullptr;
+};
+
+constexpr size_t intern_root_capacity = 1024;
+constexpr size_t intern_max_probe = 16;
+
+//  ʱȭ ߿ ϵǴ ̸   ֵ, ù   ʱȭմϴ.
+constinit intern_slot intern_root_slots[intern_root_capacity] = {};
+constinit intern_block intern_root{intern_root_slots};
+
+std::string_view intern(kangsw::hash_pack hp)
+{
+    auto const hash = static_cast<size_t>(hp.first);
+    intern_entry const* created = nullptr;
+
+    for (auto block = &intern_root;;) {
+        auto const mask = block->slots.size() - 1;
+        for (size_t probe = 0; probe < intern_max_probe; ++probe) {
+            auto& slot = block->slots[(hash + probe) & mask];
+            auto found = slot.load(std::memory_order_acquire);
+
+            if (found == nullptr) {
+                if (created == nullptr) { created = new intern_entry{hp.first, std::string(hp.second)}; }
+                if (slot.compare_exchange_strong(found, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return created->name;
+                }
+                // ٸ 尡  ä Դϴ. found  ׸  ֽϴ.
+            }
+
+            if (found->hash == hp.first) {
+                delete created;
+                return found->name;
+            }
+        }
+
+        auto next = block->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            auto const capacity = block->slots.size() * 2;
+            auto fresh = new intern_block{{new intern_slot[capacity](), capacity}};
+            if (block->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                next = fresh;
+            } else {
+                delete[] fresh->slots.data();
+                delete fresh;
+            }
+        }
+        block = next;
+    }
+}
+} // namespace
+
+pipepp::interned_name pipepp::intern_name(kangsw::hash_pack hp)
 {
-    static kangsw::safe_string_table stable_;
-    return stable_;
+    return {hp.first, intern(hp)};
 }
 
 pipepp::execution_context::timer_scope_indicator::~timer_scope_indicator()
 {
-    if (owning_) {
+    if (owning_ && self_) {
         auto& timer = self_->_wr()->timers;
         timer[index_].elapsed = clock::now() - issue_;
         self_->category_level_--;
@@ -26,40 +97,81 @@ pipepp::execution_context::execution_context()
 
 std::shared_ptr<pipepp::execution_context_data> pipepp::execution_context::_consume_read_buffer()
 {
-    std::lock_guard _0{swap_lock_};
+    std::lock_guard _0{consume_lock_};
 
-    if (!rd_buf_valid_.test(std::memory_order_acquire)) {
+    if (!can_consume_read_buffer()) {
         return {};
     }
 
+    //  ȯ ۸  ܺο  ̶, ⿡   Ƿ  Ҵմϴ.
     //   ũ⸦ ̸ ,  Ȯ忡  ݺ ޸ Ҵ մϴ.
-    auto rd = _rd();
-    auto& data = *(_rd() = std::make_shared<execution_context_data>());
-    data.debug_data.reserve(rd->debug_data.capacity());
-    data.timers.reserve(rd->timers.capacity());
+    if (auto& rd = context_data_[read_index_]; rd.use_count() > 1) {
+        auto data = std::make_shared<execution_context_data>();
+        data->debug_data.reserve(rd->debug_data.capacity());
+        data->timers.reserve(rd->timers.capacity());
+        rd = std::move(data);
+    }
 
-    rd_buf_valid_.clear();
-    return std::move(rd);
+    read_index_ = pending_.exchange(read_index_, std::memory_order_acq_rel) & pending_index_mask;
+    return context_data_[read_index_];
 }
 
-pipepp::execution_context::timer_scope_indicator pipepp::execution_context::timer_scope(kangsw::hash_pack name)
+pipepp::execution_context_data::debug_data_entity& pipepp::execution_context::_emplace_debug_data(interned_name name)
+{
+    auto& entity = _wr()->debug_data.emplace_back();
+    entity.category_level = category_level_;
+    entity.name = name.name;
+    entity.category_id = category_id_.back();
+    entity.order = _wr()->debug_data.size() + _wr()->timers.size();
+    entity.data.emplace<std::any>();
+    return entity;
+}
+
+pipepp::execution_context::timer_scope_indicator pipepp::execution_context::timer_scope(interned_name name)
 {
     timer_scope_indicator s;
+    if (!recording_) { return s; }
+
     s.self_ = this;
     s.index_ = _wr()->timers.size();
     s.issue_ = clock::now();
 
     auto& elem = _wr()->timers.emplace_back();
     elem.category_level = category_level_;
-    elem.name = string_pool()(name).second;
-    elem.category_id = name.first;
+    elem.name = name.name;
+    elem.category_id = name.hash;
+    elem.issued = s.issue_;
+    elem.thread = std::this_thread::get_id();
     elem.order = _wr()->debug_data.size() + _wr()->timers.size();
 
     category_level_++;
-    category_id_.emplace_back(name.first);
+    category_id_.emplace_back(name.hash);
     return s;
 }
 
+void pipepp::execution_context::_refresh_option_snapshot(std::shared_ptr<detail::option_snapshot const> bound)
+{
+    //  ɼ ϴ ʿ ԽϹǷ, 밡 ٲ  Խõ  ϱ⸸ մϴ.
+    retired_option_snapshots_.clear();
+    if (bound) {
+        option_snapshot_ = std::move(bound);
+        return;
+    }
+
+    if (!options_) { return; }
+    if (option_snapshot_ && option_snapshot_->generation() == options_->generation()) { return; }
+    option_snapshot_ = options_->snapshot();
+}
+
+void pipepp::execution_context::_adopt_option_snapshot()
+{
+    if (!options_) { return; }
+    if (auto snapshot = options_->snapshot(); snapshot != option_snapshot_) {
+        retired_option_snapshots_.push_back(std::move(option_snapshot_));
+        option_snapshot_ = std::move(snapshot);
+    }
+}
+
 void pipepp::execution_context::_clear_records()
 {
     _wr()->debug_data.clear();
@@ -67,11 +179,10 @@ void pipepp::execution_context::_clear_records()
 
     category_level_ = 0;
     category_id_.clear();
+    recording_ = true;
 }
 
 void pipepp::execution_context::_swap_data_buff()
 {
-    std::lock_guard _0(swap_lock_);
-    rd_buf_valid_.test_and_set(std::memory_order_release);
-    front_data_buffer_ = !front_data_buffer_;
+    write_index_ = pending_.exchange(write_index_ | pending_fresh_bit, std::memory_order_acq_rel) & pending_index_mask;
 }
@@ -0,0 +1,30 @@
+#include "pipepp/instrument_clock.hpp"
+
+#if PIPEPP_USE_TSC_CLOCK
+#include <thread>
+
+pipepp::tsc_clock::calibration_type pipepp::tsc_clock::_calibrate() noexcept
+{
+    using namespace std::chrono;
+    using steady = steady_clock;
+
+    // 일정 시간 동안 두 시계가 진행한 양을 비교해 틱당 나노초를 구합니다. 구간이 길수록 스케줄링에 의한 오차가 작아집니다.
+    auto const steady_begin = steady::now();
+    auto const tsc_begin = __rdtsc();
+    std::this_thread::sleep_for(20ms);
+    auto const steady_end = steady::now();
+    auto const tsc_end = __rdtsc();
+
+    auto const elapsed_ns = duration_cast<nanoseconds>(steady_end - steady_begin).count();
+    calibration_type c;
+    c.tsc_origin = tsc_begin;
+    c.ns_origin = duration_cast<nanoseconds>(steady_begin.time_since_epoch()).count();
+    c.ns_per_tick = double(elapsed_ns) / double(tsc_end - tsc_begin);
+    return c;
+}
+
+namespace {
+// 보정의 sleep이 첫 측정 구간에 포함되지 않도록, 정적 초기화 시점에 미리 보정합니다.
+auto const& eager_calibration = pipepp::tsc_clock::_calibration();
+} // namespace
+#endif
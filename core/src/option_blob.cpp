@@ -0,0 +1,49 @@
+#include "pipepp/option_blob.hpp"
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+struct blob_table {
+    struct entry {
+        std::weak_ptr<std::byte const> data;
+        size_t num_bytes = 0;
+    };
+
+    std::mutex lock;
+    std::unordered_map<uint64_t, entry> entries;
+    uint64_t next_handle = 1;
+    size_t sweep_threshold = 64;
+};
+
+blob_table& table()
+{
+    static blob_table inst;
+    return inst;
+}
+} // namespace
+
+uint64_t pipepp::detail::register_blob(std::shared_ptr<std::byte const> data, size_t num_bytes)
+{
+    auto& tbl = table();
+    std::lock_guard _lck{tbl.lock};
+
+    // 해제된 버퍼의 항목은 테이블이 커질 때마다 한 번에 정리하므로, 등록 비용은 상환 상수 시간입니다.
+    if (tbl.entries.size() >= tbl.sweep_threshold) {
+        std::erase_if(tbl.entries, [](auto const& pair) { return pair.second.data.expired(); });
+        tbl.sweep_threshold = std::max<size_t>(64, tbl.entries.size() * 2);
+    }
+
+    auto handle = tbl.next_handle++;
+    tbl.entries.emplace(handle, blob_table::entry{std::move(data), num_bytes});
+    return handle;
+}
+
+pipepp::detail::blob_buffer pipepp::detail::find_blob(uint64_t handle)
+{
+    auto& tbl = table();
+    std::lock_guard _lck{tbl.lock};
+
+    auto it = tbl.entries.find(handle);
+    if (it == tbl.entries.end()) { return {}; }
+    return {it->second.data.lock(), it->second.num_bytes};
+}
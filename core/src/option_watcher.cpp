@@ -0,0 +1,133 @@
+#include "pipepp/option_watcher.hpp"
+#include <fstream>
+#include "fmt/format.h"
+#include "nlohmann/json.hpp"
+#include "pipepp/pipeline.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+pipepp::option_file_watcher::option_file_watcher(
+  std::weak_ptr<detail::pipeline_base> pipeline,
+  std::filesystem::path path,
+  reload_handler_type on_reload,
+  std::chrono::milliseconds poll_interval)
+    : pipeline_(std::move(pipeline))
+    , path_(std::move(path))
+    , on_reload_(std::move(on_reload))
+    , poll_interval_(poll_interval)
+{
+    // 감시는 생성자에서 시작하므로, 생성 직후의 변경도 놓치지 않습니다.
+    std::error_code ec;
+    last_write_ = std::filesystem::last_write_time(path_, ec);
+
+#ifdef __linux__
+    // 편집기는 보통 임시 파일을 이름 변경으로 덮어쓰므로, 파일이 아닌 디렉터리를 감시합니다.
+    if (inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC); inotify_fd_ >= 0) {
+        auto dir = path_.has_parent_path() ? path_.parent_path() : std::filesystem::path{"."};
+        if (inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close(inotify_fd_);
+            inotify_fd_ = -1;
+        }
+    }
+#endif
+
+    watcher_ = std::thread{&option_file_watcher::_watch_loop, this};
+}
+
+void pipepp::option_file_watcher::stop()
+{
+    stop_.store(true);
+    if (watcher_.joinable()) { watcher_.join(); }
+
+#ifdef __linux__
+    if (inotify_fd_ >= 0) { close(inotify_fd_), inotify_fd_ = -1; }
+#endif
+}
+
+std::string pipepp::option_file_watcher::last_error() const
+{
+    std::lock_guard lock{reload_lock_};
+    return last_error_;
+}
+
+bool pipepp::option_file_watcher::reload()
+{
+    std::unique_lock lock{reload_lock_};
+    std::string error;
+    bool applied = false;
+
+    // 파싱과 검증은 실행 경로 밖인 이 스레드에서 수행하고, 교체만 파이프라인에 위임합니다.
+    if (auto pipeline = pipeline_.lock()) {
+        try {
+            std::ifstream file{path_};
+            if (!file) {
+                error = fmt::format("cannot open '{}'", path_.string());
+            } else {
+                applied = pipeline->swap_options(nlohmann::json::parse(file), &error);
+            }
+        } catch (std::exception const& e) {
+            error = e.what();
+        }
+    } else {
+        error = "pipeline expired";
+    }
+
+    (applied ? num_applied_ : num_rejected_).fetch_add(1, std::memory_order_relaxed);
+    last_error_ = error;
+
+    // 콜백이 last_error() 등을 호출할 수 있으므로, 결과를 복사해 둔 뒤 잠금을 풀고 호출합니다.
+    lock.unlock();
+    if (on_reload_) { on_reload_(applied, error); }
+    return applied;
+}
+
+void pipepp::option_file_watcher::_watch_loop()
+{
+    if (inotify_fd_ >= 0) {
+        _watch_inotify();
+    } else {
+        _watch_polling();
+    }
+}
+
+void pipepp::option_file_watcher::_watch_inotify()
+{
+#ifdef __linux__
+    auto const filename = path_.filename().string();
+    alignas(inotify_event) char buffer[4096];
+
+    while (!stop_.load()) {
+        pollfd pfd{inotify_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(poll_interval_.count())) <= 0) { continue; }
+
+        bool modified = false;
+        for (ssize_t len; (len = read(inotify_fd_, buffer, sizeof buffer)) > 0;) {
+            for (char* ptr = buffer; ptr < buffer + len;) {
+                auto event = reinterpret_cast<inotify_event const*>(ptr);
+                modified |= event->len > 0 && filename == event->name;
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (modified) { reload(); }
+    }
+#endif
+}
+
+void pipepp::option_file_watcher::_watch_polling()
+{
+    while (!stop_.load()) {
+        std::this_thread::sleep_for(poll_interval_);
+
+        std::error_code ec;
+        auto modified = std::filesystem::last_write_time(path_, ec);
+        if (ec || modified == last_write_) { continue; }
+
+        last_write_ = modified;
+        reload();
+    }
+}
@@ -1,6 +1,69 @@
 #include "pipepp/options.hpp"
 #include "fmt/format.h"
 
+void pipepp::detail::option_base::mark_modified()
+{
+    auto _lck = lock_write();
+    _mark_modified();
+}
+
+void pipepp::detail::option_base::_mark_modified()
+{
+    auto next = latest_generation_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    for (auto cur = generation(); cur < next && !generation_.compare_exchange_weak(cur, next);) {}
+
+    auto prev = snapshot_.load(std::memory_order_relaxed);
+    auto snapshot = std::make_shared<option_snapshot>();
+    snapshot->spec_ = spec_;
+    snapshot->generation_ = generation();
+    snapshot->slots_.reserve(decoders_.size());
+
+    // value()를 직접 수정해 형식 변환에 실패한 옵션은, 실행기가 항상 값을 읽을 수 있도록 이전 스냅샷의 값을 유지합니다.
+    for (size_t index = 0; index < decoders_.size(); ++index) {
+        auto& [key, decode] = decoders_[index];
+        std::shared_ptr<option_snapshot::slot_base const> slot;
+        try {
+            if (auto it = options_.find(key); it != options_.end()) { slot = decode(*it); }
+        } catch (std::exception const&) {
+        }
+
+        if (!slot && prev && prev->spec_ == spec_ && index < prev->slots_.size()) { slot = prev->slots_[index]; }
+        snapshot->slots_.push_back(std::move(slot));
+    }
+
+    snapshot_.store(std::move(snapshot), std::memory_order_release);
+
+    // 값이 바뀌어 더 이상 참조하지 않는 blob은 여기서 놓으므로, 스냅샷과 다른 사본이 사라지면 해제됩니다.
+    std::vector<std::shared_ptr<std::byte const>> blob_refs;
+    collect_blob_refs(options_, blob_refs);
+    blob_refs_ = std::move(blob_refs);
+}
+
+nlohmann::json pipepp::detail::option_base::changes_since(size_t since)
+{
+    auto _lck = lock_read();
+
+    // 마지막 기록 이후 값이 바뀐 옵션을 찾아 현재 세대로 기록합니다.
+    std::vector<stamp_type*> changed;
+    for (auto& [key, value] : options_.items()) {
+        auto& stamp = stamps_[key];
+        if (stamp.generation != 0 && stamp.value == value) { continue; }
+        stamp.value = value;
+        changed.push_back(&stamp);
+    }
+
+    // mark_modified() 없이 직접 수정된 값이라면 세대가 그대로이므로, 이전 내보내기와 구분되도록 세대를 올립니다.
+    if (!changed.empty() && generation() == stamped_generation_) { _mark_modified(); }
+    stamped_generation_ = generation();
+    for (auto stamp : changed) { stamp->generation = stamped_generation_; }
+
+    auto out = nlohmann::json::object();
+    for (auto& [key, value] : options_.items()) {
+        if (stamps_[key].generation > since) { out[key] = value; }
+    }
+    return out;
+}
+
 std::string pipepp::detail::path_tostr(const char* path, int line)
 {
     auto out = std::string(path);
@@ -7,6 +7,11 @@
 #include "kangsw/thread/thread_pool.hxx"
 #include "pipepp/options.hpp"
 #include "pipepp/pipepp.h"
+#include "pipepp/trace_recorder.hpp"
+
+namespace {
+constexpr auto OPEN_FENCE_WINDOW_END = static_cast<pipepp::fence_index_t>(~size_t{});
+}
 
 std::optional<bool> pipepp::detail::pipe_base::input_slot_t::can_submit_input(fence_index_t output_fence) const
 {
@@ -31,6 +36,30 @@ void pipepp::detail::pipe_base::input_slot_t::_prepare_next()
     for (auto& e : ready_conds_) { e = input_link_state::none; }
     active_input_fence_ = active_input_fence_.load() + 1;
     this->active_input_fence_object_.reset();
+    if (!pruned_windows_.empty()) { _skip_pruned_fences(); }
+}
+
+void pipepp::detail::pipe_base::input_slot_t::_skip_pruned_fences()
+{
+    auto const prev_fence = active_input_fence();
+    auto fence = prev_fence;
+
+    // 구간이 서로 겹칠 수 있으므로, 더 이상 건너뛸 구간이 없을 때까지 반복합니다.
+    for (bool skipped = true; skipped;) {
+        skipped = false;
+        for (auto [begin, end] : pruned_windows_) {
+            if (end != OPEN_FENCE_WINDOW_END && begin <= fence && fence < end) {
+                fence = end, skipped = true;
+            }
+        }
+    }
+
+    std::erase_if(pruned_windows_, [fence](auto& w) { return w.second <= fence; });
+    if (fence == prev_fence) { return; }
+
+    for (auto& e : ready_conds_) { e = input_link_state::none; }
+    active_input_fence_ = fence;
+    active_input_fence_object_.reset();
 }
 
 void pipepp::detail::pipe_base::input_slot_t::_propagate_fence_abortion(fence_index_t pending_fence, size_t output_link_index)
@@ -41,7 +70,9 @@ void pipepp::detail::pipe_base::input_slot_t::_propagate_fence_abortion(fence_in
     auto& link_input = output_link.input_slot_;
     auto delay = 0us;
 
-    if (auto query_result = link_input.can_submit_input(pending_fence); query_result.has_value()) {
+    if (output_link._is_pruned_fence(pending_fence)) {
+        ++output_link_index;
+    } else if (auto query_result = link_input.can_submit_input(pending_fence); query_result.has_value()) {
         if (query_result.value() && link_input._submit_input(pending_fence, owner_.id(), {}, {}, true)) {
             ++output_link_index;
         } else {
@@ -65,8 +96,8 @@ bool pipepp::detail::pipe_base::executor_slot::_wait_ready(std::chrono::millisec
     using namespace std::literals;
 
     // 잠깐동안 spinlock 돌리면서 대기
-    for (auto begin = system_clock::now();
-         system_clock::now() - begin < 50us;) {
+    for (auto begin = clock::now();
+         clock::now() - begin < 50us;) {
         if (!_is_busy()) { return true; }
 
         std::this_thread::yield();
@@ -84,18 +115,48 @@ void pipepp::detail::pipe_base::executor_slot::_launch_async(launch_args_t arg)
     assert(!_is_executor_busy());
 
     fence_index_.store(arg.fence_index);
+    launch_order_.store(arg.launch_order);
     fence_object_ = std::move(arg.fence_obj);
     cached_input_ = std::move(arg.input);
+    _stamp(&fence_stamp::enqueued);
 
     owner_.destruction_guard_.lock();
     owner_._thread_pool().add_task(&executor_slot::_launch_callback, this);
 }
 
+void pipepp::detail::pipe_base::executor_slot::_stamp(fence_stamp::time_point fence_stamp::*field)
+{
+    if (owner_.stamp_index_ < fence_object_->stamps_.size()) {
+        fence_object_->stamps_[owner_.stamp_index_].*field = clock::now();
+    }
+}
+
 kangsw::timer_thread_pool& pipepp::detail::pipe_base::executor_slot::workers()
 {
     return owner_._thread_pool();
 }
 
+bool pipepp::detail::pipe_base::executor_slot::_ensure_executor()
+{
+    bool constructed = false;
+    if (owner_.mode_stateless_) {
+        std::call_once(owner_.shared_executor_once_, [this, &constructed] {
+            auto exec = owner_.executor_factory_();
+            exec->set_workers_ref(owner_.ref_workers_);
+            owner_._warm_up_executor(*exec, context_);
+            owner_.shared_executor_ = std::move(exec);
+            constructed = true;
+        });
+    } else if (executor_ == nullptr) {
+        auto exec = owner_.executor_factory_();
+        exec->set_workers_ref(owner_.ref_workers_);
+        owner_._warm_up_executor(*exec, context_);
+        executor_ = std::move(exec);
+        constructed = true;
+    }
+    return constructed;
+}
+
 void pipepp::detail::pipe_base::executor_slot::_launch_callback()
 {
     using namespace kangsw::literals;
@@ -103,30 +164,82 @@ void pipepp::detail::pipe_base::executor_slot::_launch_callback()
     // 실행기 시동
     std::lock_guard destruction_guard{owner_.destruction_guard_};
 
-    executor()->set_context_ref(&context_write());
+    // 지연 생성 모드라면 첫 실행 시 실행기를 생성합니다.
+    // 생성과 warm-up 비용은 이 fence의 지연에 포함되므로, fence를 지표에서 제외하도록 표시합니다.
+    if (_ensure_executor()) { std::atomic_ref{fence_object_->warm_up_}.store(true, std::memory_order_relaxed); }
+    _stamp(&fence_stamp::started);
+
+    // stateless 실행기는 여러 슬롯이 공유하므로, 실행 문맥을 실행기에 기록하지 않습니다.
+    if (executor_) {
+        executor_->set_context_ref(&context_write());
+    } else {
+        context_write()._clear_records();
+    }
+    context_write()._set_recording(owner_._is_sampled_fence(fence_index_.load(std::memory_order_relaxed)));
+    context_write()._set_debug_filter(owner_._debug_filter());
+    context_write()._refresh_option_snapshot(fence_object_->_option_snapshot(owner_.pipeline_index_));
     pipe_error exec_res;
 
     PIPEPP_REGISTER_CONTEXT(context_write());
     busy_flag_.test_and_set();
     timer_scope_total_ = context_write().timer_scope("Total Execution Time");
 
+    // 재실행 fence의 대상이 아닌 파이프는 원본 fence에서 보관한 출력을 재사용합니다.
+    // 원본 fence에서 실행되지 않아 보관된 출력이 없다면, 대상 파이프처럼 다시 실행합니다.
+    bool reuse_output = false;
+
+    auto const exec_begin = clock::now();
     PIPEPP_ELAPSE_BLOCK("A. Executor Run Time")
     {
-        latest_execution_result_.store(
-          exec_res = executor()->invoke__(cached_input_, cached_output_),
-          std::memory_order_relaxed);
+        auto retained = owner_.replay_ && !fence_object_->_is_replay_target(owner_.id())
+                          ? owner_._fetch_replay_output(cached_output_, fence_object_->replay_source(), fence_index_.load())
+                          : std::nullopt;
+
+        if (retained) {
+            exec_res = *retained, reuse_output = true;
+        } else if (owner_.memo_ == nullptr) {
+            exec_res = executor()->invoke__(context_write(), cached_input_, cached_output_);
+        } else {
+            // 메모이제이션이 활성화되었다면, 캐시된 출력이 있을 때 실행기를 건너뜁니다.
+            // 실행기가 읽는 옵션 스냅샷과 공유 옵션의 세대를 키에 포함하므로, 어떤 경로로 옵션이 바뀌더라도 이전 출력은 재사용되지 않습니다.
+            auto snapshot = context_write()._option_snapshot();
+            auto const memo_key = owner_._memo_key(
+              cached_input_,
+              snapshot ? snapshot->generation() : owner_.options().generation(),
+              fence_object_->option()->generation());
+            if (auto cached = owner_._memo_fetch(memo_key, cached_input_, cached_output_)) {
+                exec_res = *cached;
+            } else {
+                // 실행기가 입력을 변경할 수 있으므로, 실행 전의 입력을 키로 보관합니다.
+                auto input = cached_input_;
+                exec_res = executor()->invoke__(context_write(), cached_input_, cached_output_);
+                owner_._memo_store(memo_key, input, exec_res, cached_output_);
+            }
+        }
+        latest_execution_result_.store(exec_res, std::memory_order_relaxed);
     }
+    owner_._accumulate_busy_time(clock::now() - exec_begin);
+    _stamp(&fence_stamp::finished);
 
     // 출력 순서까지 대기
     using namespace std::literals;
+    auto const wait_begin = clock::now();
     PIPEPP_ELAPSE_BLOCK("B. Await for output order")
     while (!_is_output_order()) { std::this_thread::sleep_for(50us); }
+    if (!fence_object_->is_warm_up_fence()) {
+        owner_.histograms_[static_cast<size_t>(pipe_histogram_t::output_wait)].record(clock::now() - wait_begin);
+    }
+    _stamp(&fence_stamp::ordered);
 
-    // 먼저, 연결된 일반 핸들러를 모두 처리합니다.
+    // 출력 순서에 따라 보관하므로, 항상 가장 최근 fence의 출력이 남습니다.
+    if (owner_.replay_ && !reuse_output) { owner_._retain_replay_output(exec_res, cached_output_, fence_index_.load()); }
+
+    // 먼저, 연결된 일반 핸들러를 모두 처리합니다. 재사용된 출력은 핸들러에 다시 전달하지 않습니다.
     PIPEPP_ELAPSE_BLOCK("C. Output Handler Overhead")
     {
         auto fence_obj = fence_object_.get();
         for (auto& fn : owner_.output_handlers_) {
+            if (reuse_output) { break; }
             fn(exec_res, *fence_obj, context_write(), cached_output_);
         }
     }
@@ -150,19 +263,30 @@ void pipepp::detail::pipe_base::executor_slot::_perform_post_output()
 
     auto constexpr RELAXED = std::memory_order_relaxed;
     // -- 연결된 모든 출력을 처리한 경우입니다.
+    _stamp(&fence_stamp::linked);
+
     // 타이머 관련 로직 처리
     timer_scope_link_.reset();
     timer_scope_total_.reset();
-    owner_._refresh_interval_timer();
-    owner_._update_latest_latency(fence_object_->launch_time_point());
+    bool const is_warm_up = fence_object_->is_warm_up_fence();
+    owner_._refresh_interval_timer(!is_warm_up);
+
+    // 샘플링에서 제외된 fence의 실행 문맥은 기록되지 않았으므로, 게시하지 않습니다.
+    bool const is_recorded = context_write().is_recording();
+    if (owner_.trace_ && is_recorded) {
+        owner_.trace_->_record(owner_.id(), index_, fence_index_.load(RELAXED), context_write()._peek_write_buffer());
+    }
+    if (!is_warm_up) { owner_._update_latest_latency(fence_object_->launch_time_point()); }
 
     // 실행기의 내부 상태를 정리합니다.
     fence_object_.reset();
     owner_._rotate_output_order(this); // 출력 순서 회전
 
     // 실행 문맥 버퍼를 전환합니다.
-    _swap_exec_context();
-    owner_.latest_exec_context_.store(&context_read(), RELAXED);
+    if (is_recorded) {
+        _swap_exec_context();
+        owner_.latest_exec_context_.store(&context_read(), RELAXED);
+    }
     owner_.latest_output_fence_.store(fence_index_.load(RELAXED), RELAXED);
 
     // fence_index_는 일종의 lock 역할을 수행하므로, 가장 마지막에 지정합니다.
@@ -178,7 +302,7 @@ void pipepp::detail::pipe_base::executor_slot::_perform_post_output()
 void pipepp::detail::pipe_base::executor_slot::_perform_output_link(size_t output_index, bool aborting)
 {
     PIPEPP_REGISTER_CONTEXT(context_write());
-    system_clock::duration total_wait_overhead = {};
+    clock::duration total_wait_overhead = {};
 
     for (; output_index < owner_.output_links_.size();) {
         assert(_is_output_order());
@@ -188,7 +312,13 @@ void pipepp::detail::pipe_base::executor_slot::_perform_output_link(size_t outpu
         using namespace std::chrono;
         auto delay = 0us;
 
-        PIPEPP_ELAPSE_SCOPE_DYNAMIC(fmt::format(":: [{}]", link.pipe->name()).c_str());
+        if (link.pipe->_is_pruned_fence(fence_index_)) {
+            // 일시 정지로 제외된 하위 그래프입니다. 입력도 abort도 전달하지 않습니다.
+            ++output_index;
+            continue;
+        }
+
+        PIPEPP_ELAPSE_SCOPE_DYNAMIC(link.label);
         if (link.pipe->is_launched() == false) {
             throw pipe_exception("linked pipe is not launched yet!");
         }
@@ -223,9 +353,9 @@ void pipepp::detail::pipe_base::executor_slot::_perform_output_link(size_t outpu
         // 다음 출력 콜백을 예약합니다.
         // workers().add_timer(delay, &executor_slot::_output_link_callback, this, output_index, aborting);
         if (delay > 0us) {
-            auto begin = system_clock::now();
+            auto begin = clock::now();
             while (!slot._wait_for_executor()) {}
-            total_wait_overhead += system_clock::now() - begin;
+            total_wait_overhead += clock::now() - begin;
         }
     }
 
@@ -252,6 +382,8 @@ pipepp::detail::pipe_base::tweak_t pipepp::detail::pipe_base::get_prelaunch_twea
       .selective_input = &mode_selectie_input_,
       .selective_output = &mode_selective_output_,
       .is_optional = &input_slot_.is_optional_,
+      .stateless = &mode_stateless_,
+      .lazy_construction = &mode_lazy_construction_,
     };
 }
 
@@ -261,6 +393,8 @@ pipepp::detail::pipe_base::const_tweak_t pipepp::detail::pipe_base::read_tweaks(
       .selective_input = &mode_selectie_input_,
       .selective_output = &mode_selective_output_,
       .is_optional = &input_slot_.is_optional_,
+      .stateless = &mode_stateless_,
+      .lazy_construction = &mode_lazy_construction_,
     };
 }
 
@@ -335,7 +469,7 @@ void pipepp::detail::pipe_base::_connect_output_to_impl(pipe_base* other, pipepp
         throw pipe_input_exception("nearlest optional node does not match");
     }
 
-    output_links_.push_back({std::move(adapter), other});
+    output_links_.push_back({std::move(adapter), other, intern_name(fmt::format(":: [{}]", other->name()))});
     other->input_links_.push_back({this});
     other->input_slot_.ready_conds_.push_back(input_slot_t::input_link_state::none);
 
@@ -364,6 +498,12 @@ void pipepp::detail::pipe_base::executor_conditions(std::vector<executor_conditi
 }
 
 void pipepp::detail::pipe_base::mark_dirty()
+{
+    executor_options_->mark_modified();
+    _mark_contexts_dirty();
+}
+
+void pipepp::detail::pipe_base::_mark_contexts_dirty()
 {
     for (auto& exec_ptr : executor_slots_) {
         exec_ptr->context_write().mark_dirty();
@@ -380,32 +520,386 @@ void pipepp::detail::pipe_base::launch(size_t num_executors, std::function<std::
         throw std::invalid_argument("invalid number of executors");
     }
 
-    // 각 슬롯 인스턴스는 동일한 실행기를 가져야 하므로, 팩토리 함수를 받아와서 생성합니다.
+    _launch_slots(num_executors, std::move(factory));
+
+    if (!mode_lazy_construction_) {
+        for (auto index : kangsw::iota(_num_executor_instances())) {
+            _construct_executor(index);
+        }
+    }
+}
+
+void pipepp::detail::pipe_base::_launch_slots(size_t num_executors, std::function<std::unique_ptr<executor_base>()>&& factory)
+{
+    if (is_launched()) {
+        throw pipe_exception("this pipe is already launched!");
+    }
+
+    if (num_executors == 0) {
+        throw std::invalid_argument("invalid number of executors");
+    }
+
+    // 각 슬롯 인스턴스는 동일한 실행기를 가져야 하므로, 팩토리 함수를 보관해 두었다가 생성합니다.
+    // stateless 모드에서는 하나의 실행기를 모든 슬롯이 공유하며, 슬롯은 실행 중인 입력의 기록만을 보관합니다.
+    // 이 때 실행기의 개수는 동시에 실행 가능한 입력의 최대 개수를 의미합니다.
+    executor_factory_ = std::move(factory);
     for (auto index : kangsw::iota(num_executors)) {
-        executor_slots_.emplace_back(std::make_unique<executor_slot>(*this, factory(), index, &options()));
+        executor_slots_.emplace_back(std::make_unique<executor_slot>(*this, nullptr, index, &options()));
     }
 
     input_slot_.active_input_fence_.store((fence_index_t)1, std::memory_order_relaxed);
 }
 
+void pipepp::detail::pipe_base::set_warm_up_input(std::any sample, size_t num_iterations)
+{
+    if (is_launched()) { throw pipe_exception("warm-up input must be set before launch!"); }
+    warm_up_input_ = std::move(sample);
+    num_warm_up_iterations_ = warm_up_input_.has_value() ? num_iterations : 0;
+}
+
+void pipepp::detail::pipe_base::_warm_up_executor(executor_base& exec, execution_context& context)
+{
+    if (num_warm_up_iterations_ == 0) { return; }
+
+    std::any input, output;
+    for (size_t i = 0; i < num_warm_up_iterations_; ++i) {
+        // 실행기가 입력을 변경할 수 있으므로, 매 회 복사본을 공급합니다.
+        input = warm_up_input_;
+        context._clear_records();
+        context._refresh_option_snapshot();
+
+        auto timer_scope_total = context.timer_scope("Total Execution Time");
+        exec.invoke__(context, input, output);
+    }
+
+    // warm-up 중에 기록된 타이머 및 디버그 데이터를 버립니다.
+    // 실행기는 이미 현재 옵션을 적용했으므로, warm-up 중 소모된 옵션 더티 플래그는 되돌리지 않습니다.
+    context._clear_records();
+}
+
+void pipepp::detail::pipe_base::set_debug_data_gated(bool gated)
+{
+    std::lock_guard lock{debug_filter_lock_};
+    debug_gated_.store(gated, std::memory_order_relaxed);
+    debug_filter_ = gated ? _make_debug_filter() : nullptr;
+}
+
+void pipepp::detail::pipe_base::subscribe_debug_data(std::string_view key)
+{
+    std::lock_guard lock{debug_filter_lock_};
+    if (debug_subscriptions_[kangsw::hash_pack{key}.first]++ == 0 && debug_filter_) {
+        debug_filter_ = _make_debug_filter();
+    }
+}
+
+void pipepp::detail::pipe_base::unsubscribe_debug_data(std::string_view key)
+{
+    std::lock_guard lock{debug_filter_lock_};
+    auto it = debug_subscriptions_.find(kangsw::hash_pack{key}.first);
+    if (it == debug_subscriptions_.end() || --it->second > 0) { return; }
+
+    debug_subscriptions_.erase(it);
+    if (debug_filter_) { debug_filter_ = _make_debug_filter(); }
+}
+
+bool pipepp::detail::pipe_base::is_debug_data_subscribed(std::string_view key) const
+{
+    std::lock_guard lock{debug_filter_lock_};
+    return debug_subscriptions_.contains(kangsw::hash_pack{key}.first);
+}
+
+std::shared_ptr<pipepp::execution_context::debug_filter_type const> pipepp::detail::pipe_base::_make_debug_filter() const
+{
+    auto filter = std::make_shared<execution_context::debug_filter_type>();
+    for (auto& [key, count] : debug_subscriptions_) { filter->insert(key); }
+    return filter;
+}
+
+std::shared_ptr<pipepp::execution_context::debug_filter_type const> pipepp::detail::pipe_base::_debug_filter() const
+{
+    // 구독 모드가 아니라면 잠금 없이 반환합니다.
+    if (!is_debug_data_gated()) { return nullptr; }
+
+    std::lock_guard lock{debug_filter_lock_};
+    return debug_filter_;
+}
+
 void pipepp::detail::pipe_base::_rotate_output_order(executor_slot* ref)
 {
-    assert(ref == executor_slots_[_pending_output_slot_index()].get());
+    assert(ref->_is_output_order());
     output_exec_slot_.fetch_add(1);
 }
 
-void pipepp::detail::pipe_base::_refresh_interval_timer()
+size_t pipepp::detail::pipe_base::_pending_output_slot_index() const
+{
+    auto const order = output_exec_slot_.load(std::memory_order_relaxed);
+    if (mode_stateless_) {
+        // 순서와 무관하게 슬롯이 할당되므로, 출력 차례의 실행 번호를 가진 슬롯을 찾습니다.
+        for (auto i : kangsw::iota(executor_slots_.size())) {
+            if (executor_slots_[i]->launch_order() == order) { return i; }
+        }
+    }
+
+    return order % executor_slots_.size();
+}
+
+size_t pipepp::detail::pipe_base::_slot_active() const
+{
+    auto const num_slots = executor_slots_.size();
+    auto const order = active_exec_slot_.load();
+    if (mode_stateless_) {
+        // 실행기가 상태를 갖지 않으므로, 순서와 무관하게 한가한 슬롯을 선택합니다.
+        for (auto i : kangsw::iota(num_slots)) {
+            auto index = (order + i) % num_slots;
+            if (!executor_slots_[index]->_is_executor_busy()) { return index; }
+        }
+    }
+
+    return order % num_slots;
+}
+
+bool pipepp::detail::pipe_base::_is_pruned_fence(fence_index_t fence) const
+{
+    // 새 구간은 begin, end 순으로 기록되므로, end를 읽은 뒤 begin이 그대로라면 두 값은 같은 구간에 속합니다.
+    for (;;) {
+        auto begin = prune_begin_.load(std::memory_order_acquire);
+        auto end = prune_end_.load(std::memory_order_acquire);
+        if (prune_begin_.load(std::memory_order_acquire) == begin) { return begin <= fence && fence < end; }
+    }
+}
+
+void pipepp::detail::pipe_base::pause()
+{
+    if (paused_.exchange(true)) { return; }
+    if (is_launched()) { _prune_paused_subgraph(); }
+}
+
+void pipepp::detail::pipe_base::unpause()
+{
+    if (!paused_.exchange(false)) { return; }
+    _restore_pruned_subgraph();
+}
+
+pipepp::detail::pipe_base& pipepp::detail::pipe_base::_front_pipe()
+{
+    auto front = this;
+    while (!front->input_links_.empty()) { front = front->input_links_.front().pipe; }
+    return *front;
+}
+
+pipepp::fence_index_t pipepp::detail::pipe_base::_front_fence()
+{
+    // 첫 파이프의 입력 락 안에서 읽은 fence는 아직 발급되지 않은 가장 작은 fence입니다.
+    auto& front = _front_pipe().input_slot_;
+    std::lock_guard lock{front.cached_input_.second};
+    return front.active_input_fence();
+}
+
+void pipepp::detail::pipe_base::_prune_paused_subgraph()
+{
+    std::lock_guard lock{prune_lock_};
+    if (!is_paused() || !pruned_subgraph_.empty() || input_links_.empty()) { return; }
+
+    // 이 파이프, 그리고 모든 입력이 하위 그래프 내부에서 오는 파이프를 수집합니다.
+    std::vector<pipe_base*> subgraph{this};
+    auto contains = [&](pipe_base* pipe) { return std::ranges::find(subgraph, pipe) != subgraph.end(); };
+    for (size_t index = 0; index < subgraph.size(); ++index) {
+        for (auto& link : subgraph[index]->output_links_) {
+            if (contains(link.pipe)) { continue; }
+            if (std::ranges::all_of(link.pipe->input_links_, [&](auto& in) { return contains(in.pipe); })) {
+                subgraph.push_back(link.pipe);
+            }
+        }
+    }
+
+    // 하위 그래프 외부로 나가는 링크가 있다면, 외부 파이프가 fence를 기다리므로 제외할 수 없습니다.
+    for (auto pipe : subgraph) {
+        for (auto& link : pipe->output_links_) {
+            if (!contains(link.pipe)) { return; }
+        }
+    }
+
+    auto const begin = _front_fence();
+    for (auto pipe : subgraph) {
+        auto& slot = pipe->input_slot_;
+        std::lock_guard input_lock{slot.cached_input_.second};
+        slot.pruned_windows_.emplace_back(begin, OPEN_FENCE_WINDOW_END);
+    }
+
+    prune_begin_.store(begin, std::memory_order_release);
+    prune_end_.store(OPEN_FENCE_WINDOW_END, std::memory_order_release);
+    pruned_subgraph_ = std::move(subgraph);
+}
+
+void pipepp::detail::pipe_base::_restore_pruned_subgraph()
+{
+    std::lock_guard lock{prune_lock_};
+    if (pruned_subgraph_.empty()) { return; }
+
+    auto const begin = prune_begin_.load(std::memory_order_relaxed);
+    auto const end = _front_fence();
+    prune_end_.store(end, std::memory_order_release);
+
+    for (auto pipe : pruned_subgraph_) {
+        auto& slot = pipe->input_slot_;
+        std::lock_guard input_lock{slot.cached_input_.second};
+        auto it = std::ranges::find(slot.pruned_windows_, std::make_pair(begin, OPEN_FENCE_WINDOW_END));
+        if (it != slot.pruned_windows_.end()) { it->second = end; }
+        slot._skip_pruned_fences();
+    }
+
+    pruned_subgraph_.clear();
+}
+
+void pipepp::detail::pipe_base::enable_memoization(
+  size_t capacity,
+  std::function<size_t(std::any const&)> input_hasher,
+  std::function<bool(std::any const&, std::any const&)> input_equal)
+{
+    if (is_launched()) { throw pipe_exception("memoization must be configured before launch!"); }
+    if (capacity == 0 || !input_hasher || !input_equal) { throw pipe_exception("invalid memoization arguments"); }
+
+    memo_ = std::make_unique<memoization_t>();
+    memo_->capacity = capacity;
+    memo_->hasher = std::move(input_hasher);
+    memo_->equal = std::move(input_equal);
+}
+
+double pipepp::detail::pipe_base::memoization_hit_rate() const
+{
+    auto hits = memoization_hits();
+    auto total = hits + memoization_misses();
+    return total ? static_cast<double>(hits) / total : 0.;
+}
+
+pipepp::detail::pipe_base::memo_key_t pipepp::detail::pipe_base::_memo_key(std::any const& input, size_t options_generation, size_t shared_generation) const
+{
+    auto hash = memo_->hasher(input);
+    for (auto generation : {options_generation, shared_generation}) {
+        auto seed = std::hash<size_t>{}(generation);
+        hash ^= seed + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return {hash, options_generation, shared_generation};
+}
+
+std::optional<pipepp::detail::pipe_base::memoization_t::entry_iterator>
+pipepp::detail::pipe_base::memoization_t::find(memo_key_t const& key, std::any const& input)
+{
+    // 해시가 같더라도 세대와 입력이 모두 같아야 같은 항목입니다.
+    for (auto [it, end] = index.equal_range(key.hash); it != end; ++it) {
+        auto& entry = *it->second;
+        if (entry.key.options_generation == key.options_generation
+            && entry.key.shared_generation == key.shared_generation
+            && equal(entry.input, input)) {
+            return it->second;
+        }
+    }
+    return {};
+}
+
+std::optional<pipepp::pipe_error> pipepp::detail::pipe_base::_memo_fetch(memo_key_t const& key, std::any const& input, std::any& output)
+{
+    std::lock_guard lock{memo_->lock};
+    auto found = memo_->find(key, input);
+    if (!found) {
+        memo_->num_miss.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+
+    auto& entries = memo_->entries;
+    entries.splice(entries.begin(), entries, *found);
+    memo_->num_hit.fetch_add(1, std::memory_order_relaxed);
+
+    output = (*found)->output;
+    return (*found)->result;
+}
+
+void pipepp::detail::pipe_base::_memo_store(memo_key_t const& key, std::any const& input, pipe_error result, std::any const& output)
+{
+    // 출력 링크로 전달되지 않는 결과는 보관하지 않습니다.
+    if (result > pipe_error::warning) { return; }
+
+    std::lock_guard lock{memo_->lock};
+    auto& entries = memo_->entries;
+    auto& index = memo_->index;
+    if (memo_->find(key, input)) { return; }
+
+    if (entries.size() >= memo_->capacity) {
+        auto last = std::prev(entries.end());
+        for (auto [it, end] = index.equal_range(last->key.hash); it != end; ++it) {
+            if (it->second == last) { index.erase(it); break; }
+        }
+        entries.pop_back();
+    }
+
+    entries.push_front({key, input, result, output});
+    index.emplace(key.hash, entries.begin());
+}
+
+
+void pipepp::detail::pipe_base::enable_replay()
+{
+    if (is_launched()) { throw pipe_exception("replay must be configured before launch!"); }
+    if (replay_ == nullptr) { replay_ = std::make_unique<replay_cache_t>(); }
+}
+
+void pipepp::detail::pipe_base::set_trace_recorder(std::shared_ptr<trace_recorder> recorder)
+{
+    if (is_launched()) { throw pipe_exception("trace recorder must be set before launch!"); }
+    if (recorder) { recorder->_register_pipe(id(), name()); }
+    trace_ = std::move(recorder);
+}
+
+std::tuple<std::any, std::shared_ptr<pipepp::base_shared_context>, pipepp::fence_index_t> pipepp::detail::pipe_base::_replay_source() const
+{
+    if (replay_ == nullptr) { return {}; }
+    std::lock_guard lock{replay_->lock};
+    return {replay_->input, replay_->fence_object, replay_->input_fence};
+}
+
+std::optional<pipepp::pipe_error> pipepp::detail::pipe_base::_fetch_replay_output(std::any& output, fence_index_t source, fence_index_t fence)
+{
+    std::lock_guard lock{replay_->lock};
+    if (!replay_->result || replay_->output_fence != source) { return {}; }
+
+    // 재실행 fence의 출력으로 다시 사용되었으므로, 이후의 재실행에서도 유효합니다.
+    replay_->output_fence = fence;
+    output = replay_->output;
+    return replay_->result;
+}
+
+void pipepp::detail::pipe_base::_retain_replay_output(pipe_error result, std::any const& output, fence_index_t fence)
+{
+    std::lock_guard lock{replay_->lock};
+    replay_->result = result;
+    replay_->output = output;
+    replay_->output_fence = fence;
+}
+
+void pipepp::detail::pipe_base::_refresh_interval_timer(bool record_histogram)
 {
     constexpr auto RELAXED = std::memory_order_relaxed;
     auto tp = latest_output_tp_.load(RELAXED);
-    latest_interval_.store(system_clock::now() - tp);
-    latest_output_tp_.compare_exchange_strong(tp, system_clock::now());
+    auto interval = clock::now() - tp;
+    latest_interval_.store(interval);
+    latest_output_tp_.compare_exchange_strong(tp, clock::now());
+    if (record_histogram) { histograms_[static_cast<size_t>(pipe_histogram_t::output_interval)].record(interval); }
 }
 
-void pipepp::detail::pipe_base::_update_latest_latency(system_clock::time_point launched)
+void pipepp::detail::pipe_base::_accumulate_busy_time(clock::duration elapsed)
+{
+    using namespace std::chrono;
+    total_busy_ns_.fetch_add(duration_cast<nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+    num_executions_.fetch_add(1, std::memory_order_relaxed);
+    histograms_[static_cast<size_t>(pipe_histogram_t::run_time)].record(elapsed);
+}
+
+void pipepp::detail::pipe_base::_update_latest_latency(clock::time_point launched)
 {
     constexpr auto RELAXED = std::memory_order_relaxed;
-    latest_output_latency_.store(system_clock::now() - launched, RELAXED);
+    auto latency = clock::now() - launched;
+    latest_output_latency_.store(latency, RELAXED);
+    histograms_[static_cast<size_t>(pipe_histogram_t::output_latency)].record(latency);
 }
 
 void pipepp::detail::pipe_base::input_slot_t::_supply_input_to_active_executor(bool is_initial_call)
@@ -428,6 +922,7 @@ void pipepp::detail::pipe_base::input_slot_t::_supply_input_to_active_executor(b
       std::move(active_input_fence_object_),
       active_input_fence(),
       std::move(cached_input_.first),
+      owner_.active_exec_slot_.load(),
     });
 
     // 다음 입력 받을 준비 완료
@@ -527,6 +1022,13 @@ bool pipepp::detail::pipe_base::input_slot_t::_submit_input_direct(std::any&& in
 
     if (owner_._active_exec_slot()._is_executor_busy()) { return false; }
 
+    if (owner_.replay_) {
+        std::lock_guard replay_lock{owner_.replay_->lock};
+        owner_.replay_->input = input;
+        owner_.replay_->fence_object = fence_object;
+        owner_.replay_->input_fence = active_input_fence();
+    }
+
     active_input_fence_object_ = std::move(fence_object);
     cached_input_.first = std::move(input);
 
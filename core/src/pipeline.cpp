@@ -1,4 +1,8 @@
+#include <latch>
+#include <map>
 #include <mutex>
+#include "fmt/format.h"
+#include "pipepp/critical_path.hpp"
 #include "pipepp/options.hpp"
 #include "pipepp/pipeline.hpp"
 
@@ -32,9 +36,16 @@ void pipepp::detail::pipeline_base::sync()
         is_busy = is_busy
                   || workers_.num_total_waitings() > 0;
     }
+
+    if (critical_path_) {
+        std::lock_guard lock(fence_object_pool_lock_);
+        for (auto& ptr : fence_objects_) {
+            if (ptr.use_count() == 1) { _collect_fence_stamps(*ptr); }
+        }
+    }
 }
 
-void pipepp::detail::pipeline_base::launch()
+void pipepp::detail::pipeline_base::launch(bool construct_in_parallel)
 {
     if (pipes_.front()->input_links().empty() == false) {
         throw pipe_link_exception("frontmost input pipe must not receive input from any other pipe.");
@@ -47,14 +58,149 @@ void pipepp::detail::pipeline_base::launch()
         }
     }
 
+#if PIPEPP_USE_TSC_CLOCK
+    // 정적 초기화 순서에 관계없이, 실행기가 처음 시각을 읽기 전에 보정을 마칩니다.
+    tsc_clock::_calibration();
+#endif
+
+    for (auto index : kangsw::iota(pipes_.size())) { pipes_[index]->_set_pipeline_index(index); }
+
+    if (replay_enabled_) {
+        for (auto& pipe : pipes_) { pipe->enable_replay(); }
+    }
+
+    if (trace_recorder_) {
+        for (auto& pipe : pipes_) { pipe->set_trace_recorder(trace_recorder_); }
+    }
+
+    if (critical_path_) {
+        std::vector<std::string> names;
+        std::vector<std::vector<size_t>> inputs;
+        for (auto index : kangsw::iota(pipes_.size())) {
+            auto& pipe = pipes_[index];
+            pipe->_enable_fence_stamps(index);
+            names.push_back(pipe->name());
+            auto& pipe_inputs = inputs.emplace_back();
+            for (auto& link : pipe->input_links()) { pipe_inputs.push_back(id_mapping_.at(link.pipe->id())); }
+        }
+        critical_path_->_set_topology(std::move(names), std::move(inputs));
+    }
+
     for (auto [pipe, tuple] : kangsw::zip(pipes_, adapters_)) {
         auto& [n_ex, handler] = tuple;
-        pipe->launch(n_ex, std::move(handler));
+        pipe->_launch_slots(n_ex, std::move(handler));
     }
 
     adapters_.clear();
     adapters_.shrink_to_fit();
+
+    // 시동 전에 일시 정지된 파이프의 하위 그래프를 제외합니다.
+    for (auto& pipe : pipes_) {
+        if (pipe->is_paused()) { pipe->_prune_paused_subgraph(); }
+    }
+
+    // 지연 생성 모드가 아닌 모든 파이프의 실행기 인스턴스를 생성합니다.
+    std::vector<std::pair<pipe_base*, size_t>> jobs;
+    for (auto& pipe : pipes_) {
+        if (pipe->read_tweaks().lazy_construction) { continue; }
+        for (auto index : kangsw::iota(pipe->_num_executor_instances())) {
+            jobs.emplace_back(pipe.get(), index);
+        }
+    }
+
+    std::vector<std::string> errors;
+    std::mutex errors_lock;
+    auto construct = [&](pipe_base* pipe, size_t index) {
+        try {
+            pipe->_construct_executor(index);
+        } catch (std::exception const& e) {
+            std::lock_guard _lck{errors_lock};
+            errors.emplace_back(fmt::format("[{}] executor {}: {}", pipe->name(), index, e.what()));
+        } catch (...) {
+            std::lock_guard _lck{errors_lock};
+            errors.emplace_back(fmt::format("[{}] executor {}: unknown exception", pipe->name(), index));
+        }
+    };
+
+    if (construct_in_parallel && jobs.size() > 1) {
+        std::latch all_done{static_cast<ptrdiff_t>(jobs.size())};
+        for (auto [pipe, index] : jobs) {
+            workers_.add_task([&construct, &all_done, pipe = pipe, index = index] {
+                construct(pipe, index);
+                all_done.count_down();
+            });
+        }
+        all_done.wait();
+    } else {
+        for (auto [pipe, index] : jobs) { construct(pipe, index); }
+    }
+
+    if (!errors.empty()) {
+        std::string message = fmt::format("failed to construct {} executor(s)", errors.size());
+        for (auto& error : errors) { message.append("\n  "), message.append(error); }
+        throw pipe_exception(message.c_str());
+    }
+}
+
+namespace {
+/**
+ * 옵션 값이 핸들로 참조하는 option_blob의 바이트열을 ___blobs 섹션에 담습니다. 옵션 값에는 핸들만 남습니다.
+ * CBOR/MessagePack에서는 바이트열 그대로, json 텍스트에서는 {"bytes": [...]} 객체로 직렬화됩니다.
+ */
+void export_blobs(nlohmann::json& opts)
+{
+    auto& blobs = opts["___blobs"] = nlohmann::json::object();
+    auto export_blob = [&](uint64_t handle) {
+        auto key = std::to_string(handle);
+        if (blobs.contains(key)) { return; }
+        if (auto buffer = pipepp::detail::find_blob(handle); buffer.data) {
+            auto bytes = reinterpret_cast<uint8_t const*>(buffer.data.get());
+            blobs[key] = nlohmann::json::binary(std::vector<uint8_t>(bytes, bytes + buffer.num_bytes));
+        }
+    };
+
+    pipepp::detail::for_each_blob_handle(opts["___shared"], export_blob);
+    pipepp::detail::for_each_blob_handle(opts["___pipes"], export_blob);
+}
+
+void remap_blob_handles(nlohmann::json& j, std::map<uint64_t, uint64_t> const& handles)
+{
+    if (pipepp::detail::is_blob_handle(j)) {
+        if (auto it = handles.find(j["___blob"].get<uint64_t>()); it != handles.end()) { j["___blob"] = it->second; }
+    } else if (j.is_structured()) {
+        for (auto& elem : j) { remap_blob_handles(elem, handles); }
+    }
+}
+
+/**
+ * ___shared, ___pipes 섹션의 사본을 반환합니다. ___blobs 섹션이 있다면 그 바이트열을 새 blob으로 등록하고, 사본의 핸들을 새로 발급된 핸들로 바꿉니다.
+ * 내보낸 쪽의 핸들은 다른 프로세스에서 발급되었을 수 있으므로 그대로 쓰지 않으며, 등록한 blob은 옵션에 반영될 때까지 keep이 소유합니다.
+ */
+std::pair<nlohmann::json, nlohmann::json> import_blobs(nlohmann::json const& in, std::vector<pipepp::option_blob<std::byte>>& keep)
+{
+    std::pair<nlohmann::json, nlohmann::json> sections{in["___shared"], in["___pipes"]};
+    auto it_blobs = in.find("___blobs");
+    if (it_blobs == in.end() || !it_blobs->is_object()) { return sections; }
+
+    std::map<uint64_t, uint64_t> handles;
+    for (auto& [key, payload] : it_blobs->items()) {
+        if (payload.is_binary()) {
+            auto& bytes = payload.get_binary();
+            keep.push_back(pipepp::option_blob<std::byte>::from_bytes(bytes.data(), bytes.size()));
+        } else if (pipepp::_is_serialized_binary(payload)) {
+            auto bytes = payload.at("bytes").get<std::vector<uint8_t>>();
+            keep.push_back(pipepp::option_blob<std::byte>::from_bytes(bytes.data(), bytes.size()));
+        } else {
+            continue;
+        }
+        handles[std::stoull(key)] = keep.back().handle();
+    }
+
+    remap_blob_handles(sections.first, handles);
+    remap_blob_handles(sections.second, handles);
+    return sections;
 }
+} // namespace
 
 void pipepp::detail::pipeline_base::export_options(nlohmann::json& opts)
 {
@@ -71,53 +217,109 @@ void pipepp::detail::pipeline_base::export_options(nlohmann::json& opts)
             opts_suspend[pipe->name()];
         }
     }
+
+    export_blobs(opts);
 }
 
-void pipepp::detail::pipeline_base::import_options(nlohmann::json const& in)
+void pipepp::detail::pipeline_base::export_options(nlohmann::json& opts, size_t since_generation)
 {
-    // 재귀적으로 옵션을 대입합니다.
-    auto _lck = options().lock_write();
-    if (!in.contains("___shared") || !in.contains("___pipes") || !in.contains("___suspended")) { return; }
-    options().value().merge_patch(in["___shared"]);
-    auto& pipes_in = in["___pipes"];
-    auto& opts_suspend = in["___suspended"];
+    // 세대를 먼저 읽어야, 내보내는 도중의 변경이 다음 내보내기에서 누락되지 않습니다.
+    opts["___generation"] = option_base::latest_generation();
+    opts["___shared"] = options().changes_since(since_generation);
+    auto& opts_pipe_section = opts["___pipes"] = nlohmann::json::object();
+    auto& opts_suspend = opts["___suspended"] = nlohmann::json::object();
 
-    using nlohmann::json;
-    auto update = [](auto& recurse, json& l, json const& r) -> void {
-        if (l.is_object() && r.is_object()) {
-            for (auto& item : l.items()) {
-                if (r.contains(item.key())) {
-                    recurse(recurse, item.value(), r.at(item.key()));
-                }
-            }
-        } else if (l.is_array() && r.is_array()) {
-            int i;
+    for (auto& pipe : pipes_) {
+        if (auto changes = pipe->options().changes_since(since_generation); !changes.empty()) {
+            opts_pipe_section[pipe->name()] = std::move(changes);
+        }
 
-            // 크기가 같다면 재귀적으로 방문 (업데이트)
-            for (i = 0; i < std::min(l.size(), r.size()); ++i) {
-                recurse(recurse, l[i], r[i]);
-            }
+        if (pipe->is_paused()) {
+            opts_suspend[pipe->name()];
+        }
+    }
 
-            // 새 배열이 더 작다면 현재 배열을 discard
-            while (r.size() < l.size()) {
-                l.erase(l.size() - 1);
-            }
+    export_blobs(opts);
+}
+
+std::vector<uint8_t> pipepp::detail::pipeline_base::export_options(option_format format, size_t since_generation)
+{
+    nlohmann::json opts;
+    export_options(opts, since_generation);
 
-            // 만약 r의 크기가 더 크다면, 일단 복사.
-            for (; i < r.size(); ++i) {
-                l[i] = r[i];
+    switch (format) {
+        case option_format::cbor: return nlohmann::json::to_cbor(opts);
+        case option_format::msgpack: return nlohmann::json::to_msgpack(opts);
+        default: {
+            auto str = opts.dump();
+            return {str.begin(), str.end()};
+        }
+    }
+}
+
+void pipepp::detail::pipeline_base::import_options(std::span<uint8_t const> in, option_format format)
+{
+    switch (format) {
+        case option_format::cbor: import_options(nlohmann::json::from_cbor(in.begin(), in.end())); break;
+        case option_format::msgpack: import_options(nlohmann::json::from_msgpack(in.begin(), in.end())); break;
+        default: import_options(nlohmann::json::parse(in.begin(), in.end())); break;
+    }
+}
+
+namespace {
+/** 기존 옵션 구조를 유지하며, 같은 키와 같은 형식의 값만 재귀적으로 덮어씁니다. */
+void merge_options(nlohmann::json& l, nlohmann::json const& r)
+{
+    // option_blob은 핸들 외에, binary 값이나 직접 작성한 설정 파일의 원소별 배열로도 대체할 수 있습니다.
+    auto is_blob = [](nlohmann::json const& j) { return pipepp::detail::is_blob_handle(j) || j.is_binary() || pipepp::_is_serialized_binary(j); };
+    if (is_blob(l) && (is_blob(r) || r.is_array())) {
+        l = r;
+    } else if (l.is_object() && r.is_object()) {
+        for (auto& item : l.items()) {
+            if (r.contains(item.key())) {
+                merge_options(item.value(), r.at(item.key()));
             }
-        } else if (strcmp(l.type_name(), r.type_name()) == 0) {
-            l = r;
         }
-    };
+    } else if (l.is_array() && r.is_array()) {
+        int i;
+
+        // 크기가 같다면 재귀적으로 방문 (업데이트)
+        for (i = 0; i < std::min(l.size(), r.size()); ++i) {
+            merge_options(l[i], r[i]);
+        }
+
+        // 새 배열이 더 작다면 현재 배열을 discard
+        while (r.size() < l.size()) {
+            l.erase(l.size() - 1);
+        }
+
+        // 만약 r의 크기가 더 크다면, 일단 복사.
+        for (; i < r.size(); ++i) {
+            l[i] = r[i];
+        }
+    } else if (strcmp(l.type_name(), r.type_name()) == 0) {
+        l = r;
+    }
+}
+} // namespace
+
+void pipepp::detail::pipeline_base::import_options(nlohmann::json const& in)
+{
+    // 재귀적으로 옵션을 대입합니다.
+    auto _lck = options().lock_write();
+    if (!in.contains("___shared") || !in.contains("___pipes") || !in.contains("___suspended")) { return; }
+    std::vector<option_blob<std::byte>> blobs;
+    auto [shared_in, pipes_in] = import_blobs(in, blobs);
+    options().value().merge_patch(shared_in);
+    options()._mark_modified();
+    auto& opts_suspend = in["___suspended"];
 
     for (auto& pipe : pipes_) {
         auto& opts = pipe->options().value();
         auto it_found = pipes_in.find(pipe->name());
         if (it_found == pipes_in.end()) { continue; }
 
-        update(update, opts, it_found.value());
+        merge_options(opts, it_found.value());
         pipe->mark_dirty();
 
         if (opts_suspend.contains(pipe->name())) {
@@ -128,6 +330,119 @@ void pipepp::detail::pipeline_base::import_options(nlohmann::json const& in)
     }
 }
 
+bool pipepp::detail::pipeline_base::swap_options(nlohmann::json const& in, std::string* error)
+{
+    using nlohmann::json;
+    auto fail = [error](std::string message) {
+        if (error) { *error = std::move(message); }
+        return false;
+    };
+
+    if (!in.contains("___shared") || !in.contains("___pipes") || !in.contains("___suspended")) {
+        return fail("missing ___shared, ___pipes or ___suspended section");
+    }
+
+    // 사본에 병합한 뒤, 각 옵션의 검증 함수로 검증합니다. 검증 함수가 값을 보정했다면 실패로 간주합니다.
+    auto verify_all = [&](option_base const& opts, json& candidate, std::string_view owner) {
+        for (auto& item : candidate.items()) {
+            if (!opts.names().contains(item.key())) { continue; }
+            if (!opts.verify(item.key(), item.value())) {
+                return fail(fmt::format("{}: option '{}' failed verification", owner, item.key()));
+            }
+        }
+        return true;
+    };
+
+    json shared;
+    std::vector<std::optional<json>> candidates(pipes_.size());
+    std::vector<option_blob<std::byte>> blobs; // 교체가 끝날 때까지 불러온 blob을 유지합니다.
+
+    // 병합으로 값의 형식이 바뀌었거나 blob 핸들이 만료되었다면 검증 함수의 형식 변환이 실패하므로, 이 또한 검증 실패로 보고합니다.
+    try {
+        auto [shared_in, pipes_in] = import_blobs(in, blobs);
+        {
+            auto _lck = options().lock_read();
+            shared = options().value();
+        }
+        shared.merge_patch(shared_in);
+        if (!verify_all(options(), shared, "___shared")) { return false; }
+
+        for (auto i : kangsw::iota(pipes_.size())) {
+            auto& pipe = *pipes_[i];
+            auto it_found = pipes_in.find(pipe.name());
+            if (it_found == pipes_in.end()) { continue; }
+
+            auto& candidate = candidates[i].emplace();
+            {
+                auto _lck = pipe.options().lock_read();
+                candidate = pipe.options().value();
+            }
+            merge_options(candidate, it_found.value());
+            if (!verify_all(pipe.options(), candidate, pipe.name())) { return false; }
+        }
+    } catch (std::exception const& e) {
+        return fail(fmt::format("invalid option value: {}", e.what()));
+    }
+
+    // fence 발급과 모든 옵션의 잠금을 잡은 상태로, 옵션과 일시 정지 상태를 한 번에 교체합니다.
+    // 교체 전에 발급된 fence는 끝까지 이전 옵션 스냅샷으로, 이후에 발급된 fence는 새 스냅샷으로 처리됩니다.
+    {
+        std::lock_guard fence_lock(fence_object_pool_lock_);
+        std::vector<decltype(options().lock_write())> locks;
+        locks.reserve(pipes_.size() + 1);
+        locks.push_back(options().lock_write());
+        for (auto& pipe : pipes_) { locks.push_back(pipe->options().lock_write()); }
+
+        options().value() = std::move(shared);
+        options()._mark_modified();
+        for (auto i : kangsw::iota(pipes_.size())) {
+            if (!candidates[i]) { continue; }
+            pipes_[i]->options().value() = std::move(*candidates[i]);
+            pipes_[i]->options()._mark_modified();
+        }
+
+        auto& opts_suspend = in["___suspended"];
+        for (auto i : kangsw::iota(pipes_.size())) {
+            if (!candidates[i]) { continue; }
+            auto& pipe = pipes_[i];
+            pipe->_mark_contexts_dirty();
+
+            if (opts_suspend.contains(pipe->name())) {
+                pipe->pause();
+            } else {
+                pipe->unpause();
+            }
+        }
+    }
+
+    return true;
+}
+
+void pipepp::detail::pipeline_base::export_executor_counts(nlohmann::json& out) const
+{
+    auto& section = out["___executors"];
+    for (auto i : kangsw::iota(pipes_.size())) {
+        auto& pipe = pipes_[i];
+        section[pipe->name()] = adapters_.empty() ? pipe->num_executors() : std::get<0>(adapters_[i]);
+    }
+}
+
+void pipepp::detail::pipeline_base::import_executor_counts(nlohmann::json const& in)
+{
+    if (adapters_.empty()) { throw pipe_exception("executor counts must be imported before launch!"); }
+    if (!in.contains("___executors")) { return; }
+    auto& section = in["___executors"];
+
+    for (auto i : kangsw::iota(pipes_.size())) {
+        auto it_found = section.find(pipes_[i]->name());
+        if (it_found == section.end()) { continue; }
+
+        auto count = it_found->get<size_t>();
+        if (count == 0) { throw pipe_exception(fmt::format("[{}] executor count must be positive", pipes_[i]->name()).c_str()); }
+        std::get<0>(adapters_[i]) = count;
+    }
+}
+
 std::shared_ptr<pipepp::base_shared_context> pipepp::detail::pipeline_base::_fetch_shared()
 {
     std::lock_guard lock(fence_object_pool_lock_);
@@ -146,12 +461,86 @@ std::shared_ptr<pipepp::base_shared_context> pipepp::detail::pipeline_base::_fet
         ref->global_options_ = global_options_.get();
     }
 
-    ref->launched_ = std::chrono::system_clock::now();
+    if (critical_path_) {
+        _collect_fence_stamps(*ref);
+        ref->stamps_.assign(pipes_.size(), {});
+        ref->stamps_collected_ = false;
+    }
+
+    ref->launched_ = instrument_clock::now();
     ref->fence_ = pipes_.front()->current_fence_index();
+    ref->replay_targets_.clear();
+    ref->replay_source_ = fence_index_t::none;
+    ref->warm_up_ = false;
+
+    // swap_options()는 이 잠금을 잡은 상태로 옵션을 교체하므로, 한 fence가 참조하는 스냅샷은 모두 교체 전이거나 모두 교체 후입니다.
+    ref->option_generation_ = option_base::latest_generation();
+    ref->option_snapshots_.resize(pipes_.size());
+    for (auto index : kangsw::iota(pipes_.size())) { ref->option_snapshots_[index] = pipes_[index]->options().snapshot(); }
 
     return ref;
 }
 
+void pipepp::detail::pipeline_base::enable_replay()
+{
+    if (pipes_.front()->is_launched()) { throw pipe_exception("replay must be configured before launch!"); }
+    replay_enabled_ = true;
+}
+
+void pipepp::detail::pipeline_base::set_trace_recorder(std::shared_ptr<trace_recorder> recorder)
+{
+    if (pipes_.front()->is_launched()) { throw pipe_exception("trace recorder must be set before launch!"); }
+    trace_recorder_ = std::move(recorder);
+}
+
+void pipepp::detail::pipeline_base::set_critical_path_analyzer(std::shared_ptr<critical_path_analyzer> analyzer)
+{
+    if (pipes_.front()->is_launched()) { throw pipe_exception("critical path analyzer must be set before launch!"); }
+    critical_path_ = std::move(analyzer);
+}
+
+void pipepp::detail::pipeline_base::_collect_fence_stamps(base_shared_context& fence)
+{
+    if (fence.stamps_collected_) { return; }
+    fence.stamps_collected_ = true;
+
+    // 실행기 생성 비용이 포함된 fence는 임계 경로 통계를 왜곡하므로 제외합니다.
+    if (!fence.is_warm_up_fence()) { critical_path_->_add(fence); }
+}
+
+bool pipepp::detail::pipeline_base::replay(pipe_id_t pipe_id)
+{
+    auto& front = *pipes_.front();
+    if (!front.is_replay_enabled() || front.is_paused() || !front.can_submit_input_direct()) { return false; }
+
+    // 이전 fence가 처리 중이라면, fence 객체를 재사용할 수 없습니다.
+    for (auto& pipe : pipes_) {
+        if (pipe->is_async_operation_running()) { return false; }
+    }
+
+    auto [input, retained, source_fence] = front._replay_source();
+    if (retained == nullptr) { return false; }
+
+    // 대상 파이프와 그 하위 그래프 전체를 수집합니다.
+    std::vector<pipe_id_t> targets{pipe_id};
+    for (size_t index = 0; index < targets.size(); ++index) {
+        for (auto& link : pipes_.at(id_mapping_.at(targets[index]))->output_links()) {
+            if (std::ranges::find(targets, link.pipe->id()) == targets.end()) {
+                targets.push_back(link.pipe->id());
+            }
+        }
+    }
+
+    // 보관된 fence 객체를 그대로 다시 공급하면 이전 fence의 시각 기록 등이 섞이므로, 일반 공급과 같이 새 fence 객체를 할당한 뒤 데이터만 복사합니다.
+    auto shared = _fetch_shared();
+    if (!_copy_shared_object(*shared, *retained)) { return false; }
+    shared->reload();
+    shared->replay_targets_ = std::move(targets);
+    shared->replay_source_ = source_fence;
+
+    return front.try_submit(std::move(input), std::move(shared));
+}
+
 std::shared_ptr<pipepp::execution_context_data> pipepp::detail::pipe_proxy_base::consume_execution_result()
 {
     auto exec_result = pipe().latest_execution_context();
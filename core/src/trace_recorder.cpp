@@ -0,0 +1,73 @@
+#include "pipepp/trace_recorder.hpp"
+#include "fmt/format.h"
+#include "nlohmann/json.hpp"
+
+void pipepp::trace_recorder::start()
+{
+    std::lock_guard lock{lock_};
+    if (events_.empty()) { origin_ = clock::now(); }
+    recording_.store(true, std::memory_order_relaxed);
+}
+
+void pipepp::trace_recorder::clear()
+{
+    std::lock_guard lock{lock_};
+    events_.clear();
+    origin_ = clock::now();
+}
+
+size_t pipepp::trace_recorder::size() const
+{
+    std::lock_guard lock{lock_};
+    return events_.size();
+}
+
+void pipepp::trace_recorder::_register_pipe(pipe_id_t id, std::string name)
+{
+    std::lock_guard lock{lock_};
+    pipe_names_[id] = std::move(name);
+}
+
+void pipepp::trace_recorder::_record(pipe_id_t pipe, size_t slot, fence_index_t fence, execution_context_data const& data)
+{
+    if (!is_recording()) { return; }
+
+    std::lock_guard lock{lock_};
+    for (auto& timer : data.timers) {
+        events_.push_back({timer.name, pipe, slot, fence, timer.thread, timer.category_level, timer.issued, timer.elapsed});
+    }
+}
+
+void pipepp::trace_recorder::write_chrome_trace(std::ostream& os) const
+{
+    using nlohmann::json;
+    using namespace std::chrono;
+    std::lock_guard lock{lock_};
+
+    auto trace = json::array();
+    std::unordered_map<std::thread::id, size_t> thread_ids;
+    auto to_us = [](auto d) { return duration_cast<duration<double, std::micro>>(d).count(); };
+
+    for (auto& ev : events_) {
+        auto [it, is_new] = thread_ids.try_emplace(ev.thread, thread_ids.size() + 1);
+        if (is_new) {
+            trace.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", it->second},
+                             {"args", {{"name", fmt::format("worker {}", it->second)}}}});
+        }
+
+        auto& pipe_name = pipe_names_.at(ev.pipe);
+        trace.push_back({
+          {"name", ev.level == 0 ? fmt::format("{}[{}]", pipe_name, ev.slot) : std::string(ev.name)},
+          {"cat", pipe_name},
+          {"ph", "X"},
+          {"ts", to_us(ev.begin - origin_)},
+          {"dur", to_us(ev.elapsed)},
+          {"pid", 1},
+          {"tid", it->second},
+          {"args", {{"pipe", pipe_name}, {"slot", ev.slot}, {"fence", static_cast<size_t>(ev.fence)}, {"scope", std::string(ev.name)}}},
+        });
+    }
+
+    trace.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", 1}, {"args", {{"name", "pipepp"}}}});
+    os << json{{"traceEvents", std::move(trace)}, {"displayTimeUnit", "ms"}}.dump();
+}
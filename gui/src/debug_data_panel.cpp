@@ -301,15 +301,36 @@ private:
                 auto& data = std::get<debug_data_desc>(slot_);
                 colapsed_or_subscribed_ = subscriber(category_, data);
             }
+            _sync_core_subscription();
         } else if (handle_unchecked && !colapsed_or_subscribed_) {
             auto uncheck_handler = m.board_ref->debug_data_unchecked;
             if (uncheck_handler) {
                 auto& data = std::get<debug_data_desc>(slot_);
                 uncheck_handler(category_, data);
             }
+            _sync_core_subscription();
         }
     }
 
+    //      ϵ, ھ  ¸ մϴ.
+    // ھ  Һں ǹǷ, ° ٲ  ϰ     մϴ.
+    void _sync_core_subscription()
+    {
+        if (colapsed_or_subscribed_ == core_subscribed_) { return; }
+
+        if (colapsed_or_subscribed_) {
+            auto pipeline = m.pipeline.lock();
+            if (!pipeline) { return; }
+
+            core_key_ = std::get<debug_data_desc>(slot_).name;
+            core_pipeline_ = m.pipeline, core_pipe_ = m.pipe;
+            pipeline->get_pipe(core_pipe_).subscribe_debug_data(core_key_);
+        } else if (auto pipeline = core_pipeline_.lock()) {
+            pipeline->get_pipe(core_pipe_).unsubscribe_debug_data(core_key_);
+        }
+        core_subscribed_ = colapsed_or_subscribed_;
+    }
+
     auto _create()
     {
         auto& r = children_.emplace_back(std::make_shared<inline_widget>(owner_, level + 1));
@@ -330,6 +351,11 @@ private:
 
     int root_height_ = 0;
     bool colapsed_or_subscribed_ = false;
+
+    bool core_subscribed_ = false;
+    std::string core_key_;
+    std::weak_ptr<pipepp::detail::pipeline_base> core_pipeline_;
+    pipepp::pipe_id_t core_pipe_ = pipepp::pipe_id_t::none;
     int text_extent_ = 0;
 
     size_t sibling_order_ = false;
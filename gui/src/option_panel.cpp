@@ -227,6 +227,8 @@ void pipepp::gui::option_panel::_update_enterbox(bool trig_modify)
         }
         API::refresh_window(m.items);
 
+        // 변경 통지는 옵션의 세대를 올리며 잠금을 다시 잡으므로, 먼저 잠금을 해제합니다.
+        _lck.unlock();
         if (on_dirty) { on_dirty(m.selected_proxy.key()); }
         m.input_enter.select(true);
     }
@@ -2,6 +2,8 @@
 #include <any>
 #include <chrono>
 #include <functional>
+#include <set>
+#include <string>
 
 #include "fmt/format.h"
 #include "nana/basic_types.hpp"
@@ -35,6 +37,18 @@ struct pipepp::gui::pipe_detail_panel::data_type {
     option_panel option{self, true};
     debug_data_panel debug_data{self, true};
     nana::listbox values{self};
+
+    // 이 패널이 코어에 구독한 키. 코어의 구독은 소비자별로 계수되므로, 구독한 만큼만 해제합니다.
+    std::multiset<std::string> core_subscriptions;
+
+    void release_core_subscriptions()
+    {
+        if (auto pl = pipeline.lock()) {
+            auto proxy = pl->get_pipe(pipe);
+            for (auto& key : core_subscriptions) { proxy.unsubscribe_debug_data(key); }
+        }
+        core_subscriptions.clear();
+    }
 };
 
 pipepp::gui::pipe_detail_panel::pipe_detail_panel(nana::window owner, const nana::rectangle& rectangle, const nana::appearance& appearance)
@@ -77,17 +91,27 @@ pipepp::gui::pipe_detail_panel::pipe_detail_panel(nana::window owner, const nana
     m.values.append_header("Name", header_div);
     m.values.append_header("Value", header_div);
     m.values.events().checked([&](nana::arg_listbox const& arg) {
+        auto& entity = arg.item.value<execution_context_data::debug_data_entity>();
+        auto pipeline = m.pipeline.lock();
+        if (!pipeline) { return; }
+        auto proxy = pipeline->get_pipe(m.pipe);
+
+        // 체크된 항목만 코어에 구독해, 구독 모드의 파이프가 해당 값을 생성하도록 합니다.
         if (arg.item.checked() == false) {
+            if (auto it = m.core_subscriptions.find(std::string{entity.name}); it != m.core_subscriptions.end()) {
+                m.core_subscriptions.erase(it);
+                proxy.unsubscribe_debug_data(entity.name);
+            }
             auto& unchecked_notify = m.board_ref->debug_data_unchecked;
             if (unchecked_notify) {
-                auto proxy = m.pipeline.lock()->get_pipe(m.pipe);
-                unchecked_notify(proxy.name(), arg.item.value<execution_context_data::debug_data_entity>());
+                unchecked_notify(proxy.name(), entity);
             }
         } else {
+            m.core_subscriptions.emplace(entity.name);
+            proxy.subscribe_debug_data(entity.name);
             auto& notify = m.board_ref->debug_data_subscriber;
             if (notify) {
-                auto proxy = m.pipeline.lock()->get_pipe(m.pipe);
-                notify(proxy.name(), arg.item.value<execution_context_data::debug_data_entity>());
+                notify(proxy.name(), entity);
             }
         }
     });
@@ -101,7 +125,11 @@ pipepp::gui::pipe_detail_panel::pipe_detail_panel(nana::window owner, const nana
         if (m.board_ref->option_changed) {
             m.board_ref->option_changed(m.pipe, std::forward<Ty_>(key));
         }
-        m.pipeline.lock()->get_pipe(m.pipe).mark_option_dirty();
+        auto pipeline = m.pipeline.lock();
+        if (pipeline == nullptr) { return; }
+
+        pipeline->get_pipe(m.pipe).mark_option_dirty();
+        pipeline->replay(m.pipe); // 재실행이 활성화된 경우, 다음 입력을 기다리지 않고 결과를 갱신합니다.
     };
 
     events().resized([&](auto&&) {
@@ -126,11 +154,15 @@ pipepp::gui::pipe_detail_panel::pipe_detail_panel(nana::window owner, const nana
     });
 }
 
-pipepp::gui::pipe_detail_panel::~pipe_detail_panel() = default;
+pipepp::gui::pipe_detail_panel::~pipe_detail_panel()
+{
+    impl_->release_core_subscriptions();
+}
 
 void pipepp::gui::pipe_detail_panel::reset_pipe(std::weak_ptr<detail::pipeline_base> pl, pipe_id_t id)
 {
     auto& m = *impl_;
+    m.release_core_subscriptions();
     m.debug_data._reset_pipe(pl, id);
 
     m.pipeline = pl;
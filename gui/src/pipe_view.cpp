@@ -1,3 +1,4 @@
+#include <array>
 #include <chrono>
 #include "fmt/format.h"
 #include "kangsw/helpers/misc.hxx"
@@ -36,9 +37,7 @@ struct pipepp::gui::pipe_view::data_type {
     std::string label_text_interval = " ms";
     std::string label_text_exec = " ms";
     std::string label_text_latency = " ms";
-    double label_dur_interval = 0;
-    double label_dur_exec = 0;
-    double label_dur_latency = 0;
+    std::string label_text_memo; // 메모이제이션이 활성화된 파이프만 표시합니다.
 
     nana::panel<true> executor_notes{self};
     struct
@@ -49,6 +48,12 @@ struct pipepp::gui::pipe_view::data_type {
     } exec_conditions = {};
 
     clock_type::time_point latest_exec_receive;
+    // 공유 히스토그램을 초기화하지 않도록, 구간 시작 시점의 스냅샷과의 차이로 최근 분포를 구합니다.
+    // 2초마다 구간을 넘기며, 직전 구간의 시작부터 현재까지(2~4초)를 표시합니다.
+    std::array<latency_histogram::snapshot_type, 3> histogram_window_begin = {};
+    std::array<latency_histogram::snapshot_type, 3> histogram_window_next = {};
+    std::pair<size_t, size_t> memo_window_begin = {}, memo_window_next = {}; // (hits, misses)
+    clock_type::time_point latest_histogram_roll;
     bool upper_node_paused = false;
 
     nana::color title_layer_color;
@@ -90,6 +95,15 @@ void pipepp::gui::pipe_view::_label_events()
         put_text(0, nana::colors::yellow, m.label_text_latency);
         put_text(1, nana::colors::light_sky_blue, m.label_text_exec);
         put_text(2, nana::colors::light_gray, m.label_text_interval);
+
+        // 메모이제이션 적중률은 실행 시간 줄의 왼쪽에 표시합니다.
+        if (!m.label_text_memo.empty()) {
+            auto extent = gp.text_extent_size(m.label_text_memo);
+            nana::point str_draw_pos = {};
+            str_draw_pos.y = 1 * (extent.height + 2) + 3;
+            str_draw_pos.x = m.label.size().width * 6 / 100;
+            gp.string(str_draw_pos, m.label_text_memo, nana::colors::light_green);
+        }
     });
 
     m.button.events().mouse_down([&](nana::arg_mouse const& arg) {
@@ -107,7 +121,7 @@ void pipepp::gui::pipe_view::_label_events()
     m.label.tooltip("Right click to suspend/resume.\n\n"
                     "Respectively from above: \n"
                     "- Output Latency from First Input\n"
-                    "- Execution Time\n"
+                    "- Execution Time (and memoization hit rate, if enabled)\n"
                     "- Output Interval\n");
 }
 
@@ -235,15 +249,31 @@ void pipepp::gui::pipe_view::update()
         m.exec_data = proxy.consume_execution_result();
         // auto time = m.exec_data->timers[0].elapsed;
 
-        auto lst_tm = {proxy.output_interval(), m.exec_data->timers[1].elapsed, proxy.output_latency()};
-        auto lst_tget = {&m.label_text_interval, &m.label_text_exec, &m.label_text_latency};
-        auto lst_lerp = {&m.label_dur_interval, &m.label_dur_exec, &m.label_dur_latency};
-        for (
-          auto [time, tget, base] :
-          kangsw::zip(lst_tm, lst_tget, lst_lerp)) {
-            auto dur = std::chrono::duration<double>(time).count() * 1000.0;
-            *base = std::lerp(*base, dur, 0.33);
-            *tget = fmt::format("{0:>10.4f} ms", *base);
+        // 단일 샘플 대신 최근 구간의 중앙값을 표시합니다.
+        using pipe_histogram_t::output_interval, pipe_histogram_t::run_time, pipe_histogram_t::output_latency;
+        auto const kinds = {output_interval, run_time, output_latency};
+        auto const lst_tget = {&m.label_text_interval, &m.label_text_exec, &m.label_text_latency};
+        bool const roll = clock_type::now() - m.latest_histogram_roll > 2s;
+        if (roll) { m.latest_histogram_roll = clock_type::now(); }
+
+        for (size_t index = 0; auto [kind, tget] : kangsw::zip(kinds, lst_tget)) {
+            auto current = proxy.histogram(kind).snapshot();
+            auto time = (current - m.histogram_window_begin[index]).percentile(50);
+            *tget = fmt::format("{0:>10.4f} ms", std::chrono::duration<double, std::milli>(time).count());
+
+            if (roll) {
+                m.histogram_window_begin[index] = std::exchange(m.histogram_window_next[index], std::move(current));
+            }
+            ++index;
+        }
+
+        // 메모이제이션 적중률도 히스토그램과 같은 구간의 누적값 차이로 구합니다.
+        if (proxy.is_memoization_enabled()) {
+            auto current = std::make_pair(proxy.memoization_hits(), proxy.memoization_misses());
+            auto hits = current.first - m.memo_window_begin.first;
+            auto total = hits + current.second - m.memo_window_begin.second;
+            m.label_text_memo = fmt::format("hit {:>5.1f}%", total ? 100. * hits / total : 0.);
+            if (roll) { m.memo_window_begin = std::exchange(m.memo_window_next, current); }
         }
         nana::drawing(m.label).update();
 
@@ -1,11 +1,26 @@
 #include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <numeric>
+#include <set>
+#include <span>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <xutility>
 
 #include "catch.hpp"
 #include "fmt/format.h"
+#include "pipepp/critical_path.hpp"
+#include "pipepp/executor_autotuner.hpp"
+#include "pipepp/input_recorder.hpp"
+#include "pipepp/load_generator.hpp"
+#include "pipepp/option_watcher.hpp"
 #include "pipepp/pipepp.h"
+#include "pipepp/trace_recorder.hpp"
 
 namespace pipepp_test::pipelines {
 using namespace pipepp;
@@ -117,4 +132,1301 @@ TEST_CASE("pipeline compilation", "")
     REQUIRE(std::ranges::count(cases, 1) == cases.size());
     REQUIRE(std::is_sorted(cases.begin(), cases.end()));
 }
+
+/** 공급에 성공할 때까지 재시도합니다. */
+template <typename Pipeline_, typename Input_, typename Fn_>
+static void suply_blocking(std::shared_ptr<Pipeline_> const& pl, Input_&& input, Fn_&& init)
+{
+    while (!pl->suply(input, init)) { pl->wait_supliable(); }
+}
+
+template <typename Pipeline_, typename Input_>
+static void suply_blocking(std::shared_ptr<Pipeline_> const& pl, Input_&& input)
+{
+    suply_blocking(pl, std::forward<Input_>(input), [](auto&&) {});
+}
+
+/** 입력 하나를 공급하고, 모든 파이프의 처리가 끝날 때까지 대기합니다. */
+template <typename Pipeline_, typename... Args_>
+static void run_fence(std::shared_ptr<Pipeline_> const& pl, Args_&&... args)
+{
+    suply_blocking(pl, std::forward<Args_>(args)...);
+    pl->sync();
+}
+
+struct exec_sum_chunks {
+    using input_type = std::vector<int>;
+    using output_type = int64_t;
+    using chunk_input_type = std::span<int const>;
+    using chunk_output_type = int64_t;
+
+    void scatter(execution_context&, input_type const& i, std::vector<chunk_input_type>& chunks)
+    {
+        constexpr size_t CHUNK_SIZE = 1000;
+        for (size_t ofst = 0; ofst < i.size(); ofst += CHUNK_SIZE) {
+            chunks.emplace_back(i.data() + ofst, std::min(CHUNK_SIZE, i.size() - ofst));
+        }
+    }
+
+    void invoke_chunk(chunk_input_type const& chunk, chunk_output_type& o) const
+    {
+        o = std::accumulate(chunk.begin(), chunk.end(), int64_t{});
+    }
+
+    pipe_error gather(execution_context&, std::vector<chunk_output_type>& chunks, output_type& o)
+    {
+        o = std::accumulate(chunks.begin(), chunks.end(), int64_t{});
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("scatter gather executor", "")
+{
+    constexpr int NUM_CASE = 32;
+    std::vector<int64_t> results(NUM_CASE);
+
+    using pipeline_type = pipeline<my_shared_data, exec_sum_chunks>;
+    auto pl = pipeline_type::make("sum", 4, &make_scatter_gather_executor<exec_sum_chunks>);
+    pl->front().add_output_handler([&](my_shared_data const& so, int64_t const& sum) {
+        results[so.level] = sum;
+    });
+    pl->launch();
+
+    for (int iter = 0; iter < NUM_CASE; ++iter) {
+        std::vector<int> input(10'000 + iter * 37);
+        std::iota(input.begin(), input.end(), iter);
+
+        suply_blocking(pl, std::move(input), [iter](my_shared_data& so) { so.level = iter; });
+    }
+    pl->sync();
+
+    for (int iter = 0; iter < NUM_CASE; ++iter) {
+        int64_t n = 10'000 + iter * 37;
+        CHECK(results[iter] == n * iter + n * (n - 1) / 2);
+    }
+}
+
+struct exec_throw_chunks : exec_sum_chunks {
+    void invoke_chunk(chunk_input_type const& chunk, chunk_output_type& o) const
+    {
+        if (std::ranges::count(chunk, 0)) { throw std::runtime_error("chunk failure"); }
+        exec_sum_chunks::invoke_chunk(chunk, o);
+    }
+};
+
+TEST_CASE("scatter gather executor exception", "")
+{
+    kangsw::timer_thread_pool workers{1024, 4};
+    scatter_gather_executor<exec_throw_chunks> exec;
+    exec.set_workers_ref(&workers);
+
+    // 작업자 스레드에서 발생한 예외도 호출 스레드로 전달되며, 호출은 대기 상태에 머무르지 않습니다.
+    execution_context ec;
+    for (int ofst : {0, 1000, 5500, 9999}) {
+        std::vector<int> input(10'000, 1);
+        input[ofst] = 0;
+        std::any in = std::move(input), out;
+        CHECK_THROWS_AS(exec.invoke__(ec, in, out), std::runtime_error);
+    }
+}
+
+struct exec_stateless {
+    inline static std::atomic_int num_instances = 0;
+
+    using input_type = int;
+    using output_type = int;
+
+    exec_stateless() { ++num_instances; }
+
+    pipe_error invoke(execution_context&, input_type const& i, output_type& o)
+    {
+        using namespace std::literals;
+        std::this_thread::sleep_for(1ms * (i % 3));
+        o = i * 2;
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("stateless executor", "")
+{
+    constexpr int NUM_CASE = 128;
+    std::vector<int> order;
+
+    using pipeline_type = pipeline<my_shared_data, exec_stateless>;
+    auto pl = pipeline_type::make("stateless", 8, &make_executor<exec_stateless>);
+    pl->front().configure_tweaks().stateless = true;
+    pl->front().add_output_handler([&](my_shared_data const& so, int const& o) {
+        CHECK(o == so.level * 2);
+        order.push_back(so.level);
+    });
+    pl->launch();
+    CHECK(exec_stateless::num_instances == 1);
+
+    for (int iter = 0; iter < NUM_CASE; ++iter) {
+        suply_blocking(pl, iter, [iter](my_shared_data& so) { so.level = iter; });
+    }
+    pl->sync();
+
+    REQUIRE(order.size() == NUM_CASE);
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+
+    // 공유 실행기처럼 문맥이 바인딩되지 않은 실행기는, 문맥 없는 호출을 거부합니다.
+    executor<exec_stateless> unbound;
+    std::any in = 1, out;
+    CHECK_THROWS_AS(unbound.invoke__(in, out), pipe_exception);
+}
+
+struct exec_counting {
+    inline static std::atomic_int num_invoke = 0;
+
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        PIPEPP_REGISTER_CONTEXT(ec);
+        PIPEPP_STORE_DEBUG_DATA("Input", i);
+        ++num_invoke, o = i;
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("executor warm-up", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_counting>;
+    auto pl = pipeline_type::make("warm-up", 4, &make_executor<exec_counting>);
+    int num_output = 0;
+    pl->front().warm_up(-1, 3).add_output_handler([&](my_shared_data const&, int const& o) {
+        CHECK(o >= 0);
+        ++num_output;
+    });
+    pl->launch();
+
+    CHECK(exec_counting::num_invoke == 4 * 3);
+    CHECK(num_output == 0);
+    CHECK(pl->front().execution_result_available() == false);
+
+    run_fence(pl, 1);
+
+    CHECK(num_output == 1);
+    CHECK(exec_counting::num_invoke == 4 * 3 + 1);
+
+    // 지연 생성 모드에서는 첫 fence가 warm-up 비용을 치르며, 그 fence는 지연 지표에서 제외됩니다.
+    auto lazy = pipeline_type::make("lazy warm-up", 1, &make_executor<exec_counting>);
+    std::vector<bool> warm_up_fences;
+    lazy->front().warm_up(-1, 2).add_output_handler([&](my_shared_data const& sd) { warm_up_fences.push_back(sd.is_warm_up_fence()); });
+    lazy->front().configure_tweaks().lazy_construction = true;
+    lazy->launch();
+    CHECK(exec_counting::num_invoke == 4 * 3 + 1);
+
+    run_fence(lazy, 1);
+    run_fence(lazy, 1);
+    CHECK(exec_counting::num_invoke == 4 * 3 + 1 + 2 + 2);
+    CHECK(warm_up_fences == std::vector{true, false});
+    CHECK(lazy->front().histogram(pipe_histogram_t::output_latency).count() == 1);
+    CHECK(lazy->front().histogram(pipe_histogram_t::run_time).count() == 2);
+}
+
+TEST_CASE("executor construction", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_stateless>;
+    std::atomic_int num_factory_calls = 0;
+    auto failing_factory = [&]() -> std::unique_ptr<executor<exec_stateless>> {
+        if (++num_factory_calls % 2 == 0) { throw std::runtime_error("factory failure"); }
+        return make_executor<exec_stateless>();
+    };
+
+    SECTION("errors are aggregated")
+    {
+        auto pl = pipeline_type::make("failing", 4, failing_factory);
+        CHECK_THROWS_AS(pl->launch(), pipe_exception);
+        CHECK(num_factory_calls == 4);
+    }
+
+    SECTION("lazy construction")
+    {
+        auto pl = pipeline_type::make("lazy", 4, failing_factory);
+        pl->front().configure_tweaks().lazy_construction = true;
+        pl->launch();
+        CHECK(num_factory_calls == 0);
+
+        run_fence(pl, 1);
+        CHECK(num_factory_calls == 1);
+    }
+}
+
+TEST_CASE("paused subgraph pruning", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_stateless>;
+    auto pl = pipeline_type::make("front", 2, &make_executor<exec_stateless>);
+    std::atomic_int num_pruned_output = 0, num_active_output = 0;
+
+    auto pruned = pl->front().create_and_link_output("pruned", 2, link_as_is, &make_executor<exec_stateless>);
+    pruned.create_and_link_output("pruned.child", 2, link_as_is, &make_executor<exec_stateless>)
+      .add_output_handler([&](my_shared_data const&, int const&) { ++num_pruned_output; });
+    pl->front().create_and_link_output("active", 2, link_as_is, &make_executor<exec_stateless>)
+      .add_output_handler([&](my_shared_data const&, int const&) { ++num_active_output; });
+    pl->launch();
+
+    auto suply_n = [&](int n) {
+        for (int i = 0; i < n; ++i) { suply_blocking(pl, i); }
+        pl->sync();
+    };
+
+    suply_n(4);
+    CHECK(num_pruned_output == 4);
+    CHECK(num_active_output == 4);
+
+    pruned.pause();
+    suply_n(8);
+    CHECK(num_pruned_output == 4);
+    CHECK(num_active_output == 12);
+    CHECK(pruned.recently_aborted() == false); // abort가 전파되지 않았음
+
+    pruned.unpause();
+    suply_n(4);
+    CHECK(num_pruned_output == 8);
+    CHECK(num_active_output == 16);
+}
+
+struct exec_memo {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_memo);
+    PIPEPP_OPTION_FULL(int, scale, 2, "memo");
+    inline static std::atomic_int num_invoke = 0;
+
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        ++num_invoke, o = i * scale(ec);
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("output memoization", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_memo>;
+    auto pl = pipeline_type::make("memo", 1, &make_executor<exec_memo>);
+    std::vector<int> outputs;
+
+    pl->front()
+      .enable_memoization(2, std::hash<int>{})
+      .add_output_handler([&](my_shared_data const&, int const& o) { outputs.push_back(o); });
+    pl->launch();
+
+    auto suply = [&](std::initializer_list<int> inputs) {
+        for (auto i : inputs) { run_fence(pl, i); }
+    };
+
+    suply({1, 2, 1, 2, 3, 1});
+    CHECK(outputs == std::vector{2, 4, 2, 4, 6, 2});
+    CHECK(exec_memo::num_invoke == 4); // 용량 2: 3 입력 시 1이 축출됨
+    CHECK(pl->front().memoization_hits() == 2);
+    CHECK(pl->front().memoization_misses() == 4);
+
+    // 옵션이 바뀌면 mark_option_dirty() 없이도 이전 출력은 재사용되지 않습니다.
+    exec_memo::scale(pl->front().options(), 3);
+    outputs.clear();
+    suply({3, 3});
+    CHECK(outputs == std::vector{9, 9});
+    CHECK(exec_memo::num_invoke == 5);
+    CHECK(pl->front().memoization_hit_rate() == Approx(3. / 8.));
+
+    // 실행기가 읽을 수 있는 공유 옵션이 바뀌어도 이전 출력은 재사용되지 않습니다.
+    pl->options().value()["memo.bias"] = 1;
+    pl->options().mark_modified();
+    outputs.clear();
+    suply({3});
+    CHECK(outputs == std::vector{9});
+    CHECK(exec_memo::num_invoke == 6);
+}
+
+TEST_CASE("output memoization hash collision", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_memo>;
+    auto pl = pipeline_type::make("memo", 1, &make_executor<exec_memo>);
+    std::vector<int> outputs;
+
+    // 모든 입력의 해시가 같더라도, 캐시는 보관한 입력을 비교해 다른 입력의 출력을 반환하지 않습니다.
+    pl->front()
+      .enable_memoization(4, [](int) { return size_t{}; })
+      .add_output_handler([&](my_shared_data const&, int const& o) { outputs.push_back(o); });
+    pl->launch();
+
+    auto const num_invoke = exec_memo::num_invoke.load();
+    for (auto i : {1, 2, 1, 3, 2}) { run_fence(pl, i); }
+    CHECK(outputs == std::vector{2, 4, 2, 6, 4});
+    CHECK(exec_memo::num_invoke == num_invoke + 3);
+    CHECK(pl->front().memoization_hits() == 2);
+}
+
+template <int Stage_>
+struct exec_replay {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_replay);
+    PIPEPP_OPTION_FULL(int, offset, 0, "replay");
+    inline static std::atomic_int num_invoke = 0;
+
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        ++num_invoke, o = i + offset(ec);
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("replay after option change", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_replay<0>>;
+    auto pl = pipeline_type::make("front", 1, &make_executor<exec_replay<0>>);
+    std::vector<int> front_outputs, tail_outputs;
+
+    pl->front().add_output_handler([&](my_shared_data const&, int const& o) { front_outputs.push_back(o); });
+    auto tail = pl->front()
+                  .create_and_link_output("tail", 1, link_as_is, &make_executor<exec_replay<1>>)
+                  .add_output_handler([&](my_shared_data const&, int const& o) { tail_outputs.push_back(o); });
+
+    CHECK(pl->replay(tail.id()) == false);
+    pl->enable_replay();
+    pl->launch();
+    CHECK(pl->replay(tail.id()) == false); // 보관된 입력 없음
+
+    pl->suply(10, [](auto&&) {});
+    pl->sync();
+    CHECK(front_outputs == std::vector{10});
+    CHECK(tail_outputs == std::vector{10});
+
+    // 마지막 파이프만 다시 실행됩니다.
+    exec_replay<1>::offset(tail.options(), 5);
+    tail.mark_option_dirty();
+    REQUIRE(pl->replay(tail.id()));
+    pl->sync();
+    CHECK(exec_replay<0>::num_invoke == 1);
+    CHECK(exec_replay<1>::num_invoke == 2);
+    CHECK(front_outputs == std::vector{10});
+    CHECK(tail_outputs == std::vector{10, 15});
+
+    // 첫 파이프를 재실행하면 하위 그래프 전체가 다시 실행됩니다.
+    exec_replay<0>::offset(pl->front().options(), 1);
+    pl->front().mark_option_dirty();
+    REQUIRE(pl->replay(pl->front().id()));
+    pl->sync();
+    CHECK(exec_replay<0>::num_invoke == 2);
+    CHECK(exec_replay<1>::num_invoke == 3);
+    CHECK(front_outputs == std::vector{10, 11});
+    CHECK(tail_outputs == std::vector{10, 15, 16});
+}
+
+TEST_CASE("replay through fresh fence", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_replay<2>>;
+    auto pl = pipeline_type::make("front", 1, &make_executor<exec_replay<2>>);
+    std::vector<int> tail_outputs;
+    std::vector<bool> tail_replays;
+    std::vector<int> tail_levels;
+
+    auto mid = pl->front().create_and_link_output("mid", 1, link_as_is, &make_executor<exec_replay<3>>);
+    auto tail = mid.create_and_link_output("tail", 1, link_as_is, &make_executor<exec_replay<4>>)
+                  .add_output_handler([&](my_shared_data const& sd, int const& o) {
+                      tail_outputs.push_back(o), tail_replays.push_back(sd.is_replay()), tail_levels.push_back(sd.level);
+                  });
+    pl->enable_replay();
+    pl->launch();
+
+    run_fence(pl, 10, [](my_shared_data& sd) { sd.level = 1; });
+
+    // mid가 일시 정지된 동안의 fence는 mid 이하에 전달되지 않으므로, mid에는 이전 fence의 출력이 보관되어 있습니다.
+    mid.pause();
+    run_fence(pl, 20, [](my_shared_data& sd) { sd.level = 2; });
+    mid.unpause();
+    CHECK(tail_outputs == std::vector{10});
+
+    // 원본 fence에서 실행되지 않은 mid는 보관된 출력을 재사용하지 않고 다시 실행됩니다.
+    auto const num_front_invoke = exec_replay<2>::num_invoke.load();
+    auto const num_mid_invoke = exec_replay<3>::num_invoke.load();
+    REQUIRE(pl->replay(tail.id()));
+    pl->sync();
+    CHECK(exec_replay<2>::num_invoke == num_front_invoke);
+    CHECK(exec_replay<3>::num_invoke == num_mid_invoke + 1);
+    CHECK(tail_outputs == std::vector{10, 20});
+    CHECK(tail_replays == std::vector{false, true});
+    CHECK(tail_levels == std::vector{1, 2}); // shared data는 새 fence 객체에 복사됩니다.
+
+    // 재실행 fence에서 다시 실행된 출력은 이후의 재실행에서 재사용됩니다.
+    REQUIRE(pl->replay(tail.id()));
+    pl->sync();
+    CHECK(exec_replay<3>::num_invoke == num_mid_invoke + 1);
+    CHECK(tail_outputs == std::vector{10, 20, 20});
+}
+
+TEST_CASE("input record and replay", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_stateless>;
+    auto path = std::filesystem::temp_directory_path() / "pipepp-test-input-record.bin";
+    auto run = [](auto&& suply_all) {
+        std::vector<std::pair<int, int>> outputs;
+        auto pl = pipeline_type::make("record", 1, &make_executor<exec_stateless>);
+        pl->front().add_output_handler([&](my_shared_data const& sd, int const& o) { outputs.emplace_back(sd.level, o); });
+        pl->launch();
+        suply_all(pl);
+        pl->sync();
+        return outputs;
+    };
+
+    auto recorded = run([&](std::shared_ptr<pipeline_type> const& pl) {
+        input_recorder<pipeline_type> recorder{
+          pl, path,
+          [](std::ostream& os, int const& i) { os.write(reinterpret_cast<char const*>(&i), sizeof i); },
+          [](std::ostream& os, my_shared_data const& sd) { os << sd.level; }};
+
+        for (int i = 0; i < 5; ++i) {
+            suply_blocking(pl, i, [i](my_shared_data& sd) { sd.level = 100 + i; });
+        }
+        CHECK(recorder.num_records() == 5);
+    });
+
+    input_replayer<pipeline_type> replayer{
+      path,
+      [](std::istream& is, int& i) { is.read(reinterpret_cast<char*>(&i), sizeof i); },
+      [](std::istream& is, my_shared_data& sd) { is >> sd.level; }};
+    REQUIRE(replayer.size() == 5);
+    CHECK(std::ranges::is_sorted(replayer.records(), {}, &input_replayer<pipeline_type>::record_type::timestamp));
+
+    auto replayed = run([&](std::shared_ptr<pipeline_type> const& pl) {
+        CHECK(replayer.play(*pl, input_replayer<pipeline_type>::rate::maximum) == 5);
+    });
+
+    CHECK(recorded.size() == 5);
+    CHECK(recorded == replayed);
+
+    // 여러 스레드에서 공급해도, 공급된 입력은 모두 한 번씩 기록됩니다.
+    auto concurrent = run([&](std::shared_ptr<pipeline_type> const& pl) {
+        input_recorder<pipeline_type> recorder{
+          pl, path,
+          [](std::ostream& os, int const& i) { os.write(reinterpret_cast<char const*>(&i), sizeof i); }};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 25; ++i) { suply_blocking(pl, t * 25 + i); }
+            });
+        }
+        for (auto& thread : threads) { thread.join(); }
+        CHECK(recorder.num_records() == 100);
+    });
+
+    input_replayer<pipeline_type> concurrent_replayer{
+      path, [](std::istream& is, int& i) { is.read(reinterpret_cast<char*>(&i), sizeof i); }};
+    std::vector<int> sorted_inputs, expected_inputs(100);
+    for (auto& record : concurrent_replayer.records()) { sorted_inputs.push_back(record.input); }
+    std::ranges::sort(sorted_inputs);
+    std::iota(expected_inputs.begin(), expected_inputs.end(), 0);
+    CHECK(concurrent.size() == 100);
+    CHECK(sorted_inputs == expected_inputs);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("latency histogram", "")
+{
+    using namespace std::chrono;
+    for (size_t i = 0; i < latency_histogram::num_buckets; ++i) {
+        auto [lower, width] = latency_histogram::_bucket_range(i);
+        CHECK(latency_histogram::_bucket_index(lower) == i);
+        CHECK(latency_histogram::_bucket_index(lower + width - 1) == i);
+    }
+
+    latency_histogram hist;
+    for (int i = 1; i <= 1000; ++i) { hist.record(microseconds(i)); }
+    CHECK(hist.count() == 1000);
+    CHECK(hist.min() == 1us);
+    CHECK(hist.max() == 1000us);
+    CHECK(std::abs(hist.percentile(50).count() - 500'000) < 500'000 / 16);
+    CHECK(std::abs(hist.percentile(99).count() - 990'000) < 990'000 / 16);
+    CHECK(hist.percentile(100) == 1000us);
+
+    // 스냅샷 차이는 공유 히스토그램을 초기화하지 않고 그 사이의 기록만 반영합니다.
+    auto begin = hist.snapshot();
+    for (int i = 0; i < 100; ++i) { hist.record(milliseconds(5)); }
+    auto window = hist.snapshot() - begin;
+    CHECK(window.count == 100);
+    CHECK(std::abs(window.percentile(50).count() - 5'000'000) < 5'000'000 / 16);
+    CHECK(hist.count() == 1100);
+}
+
+TEST_CASE("open-loop load generator", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_stateless>;
+    using generator_type = load_generator<pipeline_type>;
+
+    auto pl = pipeline_type::make("load", 1, &make_executor<exec_stateless>);
+    generator_type gen{pl, pl->front(), [](size_t i) { return int(i % 2) + 1; }};
+    pl->launch();
+
+    // 실행 시간보다 훨씬 짧은 간격으로 공급하면 포화되어 입력이 버려져야 합니다.
+    auto report = gen.run(generator_type::fixed_rate(20'000, 200));
+    CHECK(report.num_offered == 200);
+    CHECK(report.num_supplied + report.num_dropped == 200);
+    CHECK(report.num_dropped > 0);
+    CHECK(report.num_completed == report.num_supplied);
+    CHECK(gen.latency().count() == report.num_completed);
+    CHECK(gen.latency().percentile(50) <= gen.latency().percentile(99));
+    CHECK(gen.latency().min() >= std::chrono::milliseconds(1));
+
+    auto poisson = generator_type::poisson(1000, 50, 42);
+    CHECK(poisson == generator_type::poisson(1000, 50, 42));
+    CHECK(std::ranges::is_sorted(poisson));
+
+    using std::chrono::milliseconds;
+    auto burst = generator_type::trace({milliseconds(5), milliseconds(5), milliseconds(5), milliseconds(5), milliseconds(25)});
+    CHECK(burst.front() == milliseconds(0));
+    report = gen.run(burst);
+    CHECK(report.num_offered == 5);
+    CHECK(report.num_dropped > 0);
+
+    // 입력 생성이 늦어져 예정보다 늦게 공급되더라도, 지연은 예정 도착 시각부터 측정됩니다.
+    auto slow_pl = pipeline_type::make("load.slow", 1, &make_executor<exec_stateless>);
+    generator_type slow_gen{slow_pl, slow_pl->front(), [](size_t i) {
+                                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                                return int(i % 2) + 1;
+                            }};
+    slow_pl->launch();
+    report = slow_gen.run(generator_type::fixed_rate(50, 3));
+    CHECK(report.num_completed == 3);
+    CHECK(slow_gen.latency().min() >= std::chrono::milliseconds(5));
+}
+
+struct exec_sleep {
+    using input_type = int;
+    using output_type = int;
+
+    explicit exec_sleep(int ms)
+        : duration_(ms)
+    {
+    }
+
+    pipe_error invoke(execution_context&, input_type const& i, output_type& o)
+    {
+        std::this_thread::sleep_for(duration_);
+        o = i;
+        return pipe_error::ok;
+    }
+
+    static auto factory(int ms) { return make_executor<exec_sleep>(ms); }
+
+private:
+    std::chrono::milliseconds duration_;
+};
+
+TEST_CASE("executor count autotuning", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_sleep>;
+    auto factory = [] {
+        auto pl = pipeline_type::make("fast", 4, &exec_sleep::factory, 0);
+        auto slow = pl->front().create_and_link_output("slow", 4, link_as_is, &exec_sleep::factory, 6);
+        return std::make_pair(pl, slow);
+    };
+
+    nlohmann::json counts;
+    factory().first->export_executor_counts(counts);
+    CHECK(counts["___executors"]["slow"] == 4);
+
+    counts["___executors"]["slow"] = 2;
+    auto [pl, slow] = factory();
+    pl->import_executor_counts(counts);
+    pl->launch();
+    CHECK(slow.num_executors() == 2);
+    CHECK_THROWS(pl->import_executor_counts(counts));
+
+    // 6ms 걸리는 파이프에 4ms 간격으로 공급하려면 실행기가 두 개 이상 필요합니다.
+    // 대표 입력이 적더라도, 각 시행은 순환 공급으로 정해진 개수의 fence를 측정합니다.
+    using namespace std::literals;
+    executor_autotuner<pipeline_type> tuner{factory, std::vector<int>(3)};
+    auto tuned = tuner.tune({.throughput_hz = 250, .trial_duration = 240ms, .min_fences_per_trial = 30});
+    REQUIRE(tuner.trials().size() > 1);
+    CHECK(tuner.trials().front().report.num_offered == 60);
+    CHECK(tuner.trials().front().report.num_dropped > 0);
+    CHECK(tuner.trials().back().satisfied);
+    CHECK(tuned["___executors"]["fast"] == 1);
+    CHECK(tuned["___executors"]["slow"] >= 2);
+}
+
+TEST_CASE("pipe time histograms", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_sleep>;
+    auto pl = pipeline_type::make("front", 2, &exec_sleep::factory, 1);
+    auto tail = pl->front().create_and_link_output("tail", 2, link_as_is, &exec_sleep::factory, 2);
+    pl->launch();
+
+    constexpr int NUM_FENCES = 20;
+    for (int i = 0; i < NUM_FENCES; ++i) {
+        suply_blocking(pl, i);
+    }
+    pl->sync();
+
+    using namespace std::chrono_literals;
+    for (auto kind : {pipe_histogram_t::output_interval, pipe_histogram_t::output_latency, pipe_histogram_t::run_time, pipe_histogram_t::output_wait}) {
+        CHECK(tail.histogram(kind).count() == NUM_FENCES);
+    }
+    CHECK(tail.percentile(pipe_histogram_t::run_time, 50) >= 2ms);
+    CHECK(pl->front().percentile(pipe_histogram_t::run_time, 50) < tail.percentile(pipe_histogram_t::run_time, 50));
+    CHECK(tail.percentile(pipe_histogram_t::output_latency, 50) >= 3ms);
+    CHECK(tail.percentile(pipe_histogram_t::output_latency, 50) <= tail.percentile(pipe_histogram_t::output_latency, 99));
+
+    tail.reset_histograms();
+    CHECK(tail.histogram(pipe_histogram_t::output_latency).count() == 0);
+    CHECK(pl->front().histogram(pipe_histogram_t::output_latency).count() == NUM_FENCES);
+}
+
+TEST_CASE("chrome trace export", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_sleep>;
+    auto pl = pipeline_type::make("front", 2, &exec_sleep::factory, 1);
+    pl->front().create_and_link_output("tail", 2, link_as_is, &exec_sleep::factory, 1);
+
+    auto recorder = std::make_shared<trace_recorder>();
+    pl->set_trace_recorder(recorder);
+    pl->launch();
+    CHECK_THROWS(pl->set_trace_recorder(recorder));
+
+    // 시작 전의 실행은 기록되지 않습니다.
+    run_fence(pl, -1);
+    CHECK(recorder->size() == 0);
+
+    constexpr int NUM_FENCES = 8;
+    recorder->start();
+    for (int i = 0; i < NUM_FENCES; ++i) {
+        suply_blocking(pl, i);
+    }
+    pl->sync();
+    recorder->stop();
+
+    std::stringstream ss;
+    recorder->write_chrome_trace(ss);
+    auto trace = nlohmann::json::parse(ss.str());
+
+    std::map<std::string, std::set<size_t>> fences;
+    size_t num_threads = 0;
+    for (auto& ev : trace["traceEvents"]) {
+        if (ev["ph"] == "M") {
+            num_threads += ev["name"] == "thread_name";
+            continue;
+        }
+        CHECK(ev["ph"] == "X");
+        CHECK(ev["dur"].get<double>() >= 0);
+        if (ev["args"]["scope"] == "Total Execution Time") {
+            fences[ev["args"]["pipe"]].insert(ev["args"]["fence"].get<size_t>());
+            CHECK(ev["dur"].get<double>() >= 1000);
+        }
+    }
+    CHECK(num_threads > 0);
+    CHECK(fences["front"].size() == NUM_FENCES);
+    CHECK(fences["tail"] == fences["front"]);
+}
+
+TEST_CASE("critical path analysis", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_sleep>;
+    using segment_t = critical_path_analyzer::segment_t;
+
+    auto pl = pipeline_type::make("front", 2, &exec_sleep::factory, 0);
+    auto join = pl->create("join", 2, &exec_sleep::factory, 0);
+    pl->front().create_and_link_output("fast", 2, link_as_is, &exec_sleep::factory, 1).link_output(join, link_as_is);
+    pl->front().create_and_link_output("slow", 2, link_as_is, &exec_sleep::factory, 8).link_output(join, link_as_is);
+
+    auto analyzer = std::make_shared<critical_path_analyzer>();
+    pl->set_critical_path_analyzer(analyzer);
+    pl->launch();
+
+    constexpr int NUM_FENCES = 10;
+    join.add_output_handler([&](my_shared_data const& sd) { CHECK(sd.stamps().size() == 4); });
+
+    // 대기열 지연이 섞이지 않도록, fence를 하나씩 처리합니다.
+    for (int i = 0; i < NUM_FENCES; ++i) {
+        run_fence(pl, i);
+    }
+
+    CHECK(analyzer->num_fences() == NUM_FENCES);
+    CHECK(analyzer->num_on_path("join") == NUM_FENCES);
+    CHECK(analyzer->num_on_path("slow") == NUM_FENCES);
+    CHECK(analyzer->num_on_path("fast") == 0);
+
+    auto report = analyzer->report();
+    REQUIRE(report.empty() == false);
+    CHECK(report.front().pipe == "slow");
+    CHECK(report.front().segment == segment_t::run);
+    CHECK(report.front().num_bounding == NUM_FENCES);
+    CHECK(report.front().total >= std::chrono::milliseconds(8 * NUM_FENCES));
+}
+
+TEST_CASE("execution context triple buffer", "")
+{
+    execution_context context;
+    auto publish = [&](int value) {
+        context._clear_records();
+        {
+            auto _0 = context.timer_scope("publish");
+            context.store_debug_data("value", value);
+        }
+        context._swap_data_buff();
+    };
+    auto value_of = [](auto& data) { return std::get<int64_t>(data->debug_data.at(0).data); };
+
+    CHECK(context._consume_read_buffer() == nullptr);
+
+    // 읽는 쪽이 버퍼를 가져가지 않는 동안에는 가장 최근 결과만 남습니다.
+    publish(1), publish(2), publish(3);
+    REQUIRE(context.can_consume_read_buffer());
+    auto first = context._consume_read_buffer();
+    REQUIRE(first);
+    CHECK(value_of(first) == 3);
+    CHECK(context.can_consume_read_buffer() == false);
+    CHECK(context._consume_read_buffer() == nullptr);
+
+    // 이전 결과를 놓아주면 버퍼를 재할당 없이 돌려가며 사용합니다.
+    std::set<execution_context_data const*> buffers;
+    for (int i = 0; i < 8; ++i) {
+        first.reset();
+        publish(i);
+        first = context._consume_read_buffer();
+        REQUIRE(first);
+        CHECK(value_of(first) == i);
+        buffers.insert(first.get());
+    }
+    CHECK(buffers.size() <= 3);
+
+    // 이전 결과를 계속 참조하는 경우, 내용이 덮어써지지 않습니다.
+    publish(100);
+    auto next = context._consume_read_buffer();
+    publish(200);
+    auto last = context._consume_read_buffer();
+    REQUIRE((next && last));
+    CHECK(value_of(first) == 7);
+    CHECK(value_of(next) == 100);
+    CHECK(value_of(last) == 200);
+}
+
+TEST_CASE("instrument clock", "")
+{
+    using namespace std::chrono;
+    static_assert(instrument_clock::is_steady);
+
+#if PIPEPP_USE_TSC_CLOCK
+    // 보정은 정적 초기화 시점에 끝나므로, 첫 now() 호출이 보정을 기다리지 않습니다.
+    auto const first_call_begin = steady_clock::now();
+    instrument_clock::now();
+    CHECK(steady_clock::now() - first_call_begin < 5ms);
+#endif
+
+    bool is_monotonic = true;
+    auto prev = instrument_clock::now();
+    for (int i = 0; i < 10000; ++i) {
+        auto now = instrument_clock::now();
+        is_monotonic = is_monotonic && now >= prev;
+        prev = now;
+    }
+    CHECK(is_monotonic);
+
+    // 보정된 시계는 steady_clock과 같은 속도로 진행해야 합니다.
+    auto const steady_begin = steady_clock::now();
+    auto const begin = instrument_clock::now();
+    std::this_thread::sleep_for(50ms);
+    auto const elapsed = duration_cast<microseconds>(instrument_clock::now() - begin);
+    auto const steady_elapsed = duration_cast<microseconds>(steady_clock::now() - steady_begin);
+    CHECK(std::abs(elapsed.count() - steady_elapsed.count()) < steady_elapsed.count() / 20);
+}
+
+struct exec_sampled {
+    using input_type = int;
+    using output_type = int;
+
+    inline static std::atomic_int num_evaluated = 0;
+    static int evaluate(int value) { return ++num_evaluated, value; }
+
+    pipe_error invoke(execution_context& so, input_type const& i, output_type& o)
+    {
+        PIPEPP_REGISTER_CONTEXT(so);
+        PIPEPP_ELAPSE_SCOPE("Sampled Timer");
+        PIPEPP_STORE_DEBUG_STR("Sampled Value", evaluate(i));
+        o = i;
+        return pipe_error::ok;
+    }
+
+    static auto factory() { return make_executor<exec_sampled>(); }
+};
+
+TEST_CASE("instrumentation sampling", "")
+{
+    auto pl = pipeline<my_shared_data, exec_sampled>::make("sampled", 1, &exec_sampled::factory);
+    auto proxy = pl->front();
+    proxy.set_instrument_sampling(4);
+    pl->launch();
+
+    auto supply_all = [&](int num_fences) {
+        for (int i = 0; i < num_fences; ++i) {
+            run_fence(pl, i);
+        }
+    };
+
+    // 샘플링된 fence에서만 디버그 값이 평가되고, 실행 문맥이 게시됩니다.
+    supply_all(16);
+    CHECK(exec_sampled::num_evaluated == 4);
+    CHECK(proxy.num_executions() == 16);
+
+    auto result = proxy.consume_execution_result();
+    REQUIRE(result);
+    CHECK(result->debug_data.size() == 1);
+    CHECK(std::ranges::count_if(result->timers, [](auto& tm) { return tm.name == "Sampled Timer"; }) == 1);
+
+    proxy.set_instrument_sampling(0);
+    supply_all(8);
+    CHECK(exec_sampled::num_evaluated == 4);
+    CHECK(proxy.execution_result_available() == false);
+}
+
+TEST_CASE("debug data subscription", "")
+{
+    auto pl = pipeline<my_shared_data, exec_sampled>::make("gated", 1, &exec_sampled::factory);
+    auto proxy = pl->front();
+    pl->launch();
+
+    auto run_once = [&] {
+        run_fence(pl, 0);
+        auto result = proxy.consume_execution_result();
+        REQUIRE(result);
+        REQUIRE(result->debug_data.size() == 1);
+        return result->debug_data.front();
+    };
+
+    // 구독 모드가 아니라면 모든 값을 기록합니다.
+    auto const base = exec_sampled::num_evaluated.load();
+    CHECK(std::holds_alternative<std::string>(run_once().data));
+    CHECK(exec_sampled::num_evaluated == base + 1);
+
+    // 구독하지 않은 키는 값을 생성하지 않고 이름만 기록합니다.
+    proxy.set_debug_data_gated(true);
+    auto entity = run_once();
+    CHECK(entity.name == "Sampled Value");
+    REQUIRE(std::holds_alternative<std::any>(entity.data));
+    CHECK(std::get<std::any>(entity.data).has_value() == false);
+    CHECK(exec_sampled::num_evaluated == base + 1);
+
+    proxy.subscribe_debug_data("Sampled Value");
+    CHECK(proxy.is_debug_data_subscribed("Sampled Value"));
+    CHECK(std::holds_alternative<std::string>(run_once().data));
+    CHECK(exec_sampled::num_evaluated == base + 2);
+
+    // 구독은 소비자별로 계수되므로, 한 소비자가 해제해도 다른 소비자의 구독은 유지됩니다.
+    proxy.subscribe_debug_data("Sampled Value");
+    proxy.unsubscribe_debug_data("Sampled Value");
+    CHECK(proxy.is_debug_data_subscribed("Sampled Value"));
+    CHECK(std::holds_alternative<std::string>(run_once().data));
+    CHECK(exec_sampled::num_evaluated == base + 3);
+
+    proxy.unsubscribe_debug_data("Sampled Value");
+    proxy.unsubscribe_debug_data("Sampled Value");
+    CHECK_FALSE(proxy.is_debug_data_subscribed("Sampled Value"));
+    run_once();
+    CHECK(exec_sampled::num_evaluated == base + 3);
+}
+
+TEST_CASE("string interning", "")
+{
+    auto name = intern_name("Interned Name");
+    CHECK(name.name == "Interned Name");
+    CHECK(name.hash == kangsw::hash_pack{"Interned Name"}.first);
+
+    // 같은 이름은 어디서 등록하든 전역 테이블의 같은 문자열을 참조합니다.
+    std::string dynamic = "Interned Name";
+    CHECK(intern_name(dynamic).name.data() == name.name.data());
+
+    // 계측 매크로의 리터럴 이름은 정적 초기화 시점에 등록된 것을 그대로 참조합니다.
+    auto& literal = detail::static_interned_name<"Interned Literal">;
+    CHECK(literal.name == "Interned Literal");
+    CHECK(intern_name("Interned Literal").name.data() == literal.name.data());
+
+    // 여러 스레드가 동시에 첫 블록을 넘치도록 등록해도, 이름마다 단 하나의 항목만 만들어집니다.
+    constexpr int NUM_THREADS = 4, NUM_NAMES = 4096;
+    std::vector<std::vector<char const*>> addresses(NUM_THREADS);
+    std::vector<std::thread> threads;
+    for (auto& thread_addresses : addresses) {
+        threads.emplace_back([&thread_addresses] {
+            for (int i = 0; i < NUM_NAMES; ++i) {
+                auto key = fmt::format("Interned Name {}", i);
+                thread_addresses.push_back(intern_name(key).name.data());
+            }
+        });
+    }
+    for (auto& th : threads) { th.join(); }
+
+    CHECK(std::ranges::all_of(addresses, [&](auto& thread_addresses) { return thread_addresses == addresses.front(); }));
+    CHECK(std::set(addresses.front().begin(), addresses.front().end()).size() == NUM_NAMES);
+    CHECK(intern_name(fmt::format("Interned Name {}", NUM_NAMES - 1)).name == fmt::format("Interned Name {}", NUM_NAMES - 1));
+}
+
+TEST_CASE("link timer labels", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_sleep>;
+    auto pl = pipeline_type::make("front", 1, &exec_sleep::factory, 0);
+    pl->front().create_and_link_output("tail", 1, link_as_is, &exec_sleep::factory, 0);
+    pl->launch();
+
+    run_fence(pl, 0);
+
+    auto result = pl->front().consume_execution_result();
+    REQUIRE(result);
+    auto it = std::ranges::find(result->timers, std::string_view{":: [tail]"}, &execution_context_data::timer_entity::name);
+    REQUIRE(it != result->timers.end());
+
+    // 링크 타이머 이름은 연결 시 한 번 등록된 문자열을 그대로 참조합니다.
+    CHECK(it->name.data() == intern_name(":: [tail]").name.data());
+}
+
+struct exec_scaled {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_scaled);
+    PIPEPP_OPTION_FULL(int, scale, 1, "snapshot");
+
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        // 음수 입력은 옵션을 변경한 뒤 곧바로 다시 읽습니다.
+        if (i < 0) { scale(ec, -i); }
+        o = scale(ec);
+        return pipe_error::ok;
+    }
+};
+
+TEST_CASE("option snapshots", "")
+{
+    auto pl = pipeline<my_shared_data, exec_scaled>::make("scaled", 2, &make_executor<exec_scaled>);
+    auto proxy = pl->front();
+    std::vector<int> outputs;
+    proxy.add_output_handler([&](my_shared_data const&, int const& o) { outputs.push_back(o); });
+    pl->launch();
+
+    auto run = [&](int input) {
+        run_fence(pl, input);
+    };
+
+    run(0), run(0);
+    exec_scaled::scale(proxy.options(), 5);
+    run(0), run(0);
+    run(-4), run(0), run(0);
+    CHECK(outputs == std::vector{1, 1, 5, 5, 4, 4, 4});
+
+    // 같은 세대의 스냅샷은 모든 슬롯이 공유하고, 옵션이 변경되면 새로 생성됩니다.
+    auto& options = proxy.options();
+    auto snapshot = options.snapshot();
+    CHECK(snapshot == options.snapshot());
+    REQUIRE(snapshot->find<int>(&detail::_opt_spec<exec_scaled>(), exec_scaled::scale.index_));
+    CHECK(*snapshot->find<int>(&detail::_opt_spec<exec_scaled>(), exec_scaled::scale.index_) == 4);
+    CHECK(snapshot->find<int>(&detail::_opt_spec<exec_replay<0>>(), exec_scaled::scale.index_) == nullptr);
+
+    proxy.mark_option_dirty();
+    CHECK(snapshot != options.snapshot());
+
+    // 스냅샷은 변경하는 쪽에서 게시됩니다. 형식이 맞지 않는 값은 이전 값을 유지해, 실행기는 항상 값을 읽을 수 있습니다.
+    exec_scaled::scale(options, 7);
+    CHECK(*options.snapshot()->find<int>(&detail::_opt_spec<exec_scaled>(), exec_scaled::scale.index_) == 7);
+    {
+        auto _lck = options.lock_write();
+        options.value()[exec_scaled::scale.key_] = "not a number";
+        options._mark_modified();
+    }
+    CHECK(*options.snapshot()->find<int>(&detail::_opt_spec<exec_scaled>(), exec_scaled::scale.index_) == 7);
+    run(0);
+    CHECK(outputs.back() == 7);
+}
+
+struct exec_watched {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_watched);
+    PIPEPP_OPTION_FULL(int, limit, 1, "watch", "", verify::clamp(0, 10));
+
+    using input_type = int;
+    using output_type = int;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o) { return o = std::min(i, limit(ec)), pipe_error::ok; }
+};
+
+TEST_CASE("option file hot reload", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_watched>;
+    auto pl = pipeline_type::make("first", 1, &make_executor<exec_watched>);
+    auto second = pl->front().create_and_link_output("second", 1, link_as_is, &make_executor<exec_watched>);
+    auto first = pl->front();
+    int output = 0;
+    second.add_output_handler([&](my_shared_data const&, int const& o) { output = o; });
+    pl->launch();
+
+    nlohmann::json opts;
+    pl->export_options(opts);
+    opts["___pipes"]["first"]["watch.limit"] = 3;
+    opts["___pipes"]["second"]["watch.limit"] = 4;
+    auto generation = detail::option_base::latest_generation();
+    CHECK(pl->swap_options(opts));
+    CHECK(exec_watched::limit(first.options()) == 3);
+    CHECK(exec_watched::limit(second.options()) == 4);
+    CHECK(detail::option_base::latest_generation() > generation);
+    generation = detail::option_base::latest_generation();
+
+    // 한 파이프라도 검증에 실패하면, 다른 파이프도 변경되지 않습니다.
+    std::string error;
+    opts["___pipes"]["first"]["watch.limit"] = 5;
+    opts["___pipes"]["second"]["watch.limit"] = 50;
+    CHECK_FALSE(pl->swap_options(opts, &error));
+    CHECK(error.find("watch.limit") != std::string::npos);
+    CHECK(exec_watched::limit(first.options()) == 3);
+    CHECK(exec_watched::limit(second.options()) == 4);
+    CHECK(detail::option_base::latest_generation() == generation);
+
+    // 병합으로 형식이 바뀐 값은 예외 대신 검증 실패로 보고됩니다.
+    pl->options().reset_as_default<exec_watched>();
+    generation = detail::option_base::latest_generation();
+    auto shared_opts = opts;
+    shared_opts["___shared"]["watch.limit"] = "text";
+    CHECK_FALSE(pl->swap_options(shared_opts, &error));
+    CHECK(error.find("invalid option value") != std::string::npos);
+    CHECK(exec_watched::limit(pl->options()) == 1);
+    CHECK(detail::option_base::latest_generation() == generation);
+
+    auto path = std::filesystem::temp_directory_path() / "pipepp-test-options.json";
+    auto write = [&](std::string const& content) { std::ofstream{path} << content; };
+    auto wait_for = [](auto&& pred) {
+        using namespace std::literals;
+        for (auto until = std::chrono::steady_clock::now() + 5s; !pred() && std::chrono::steady_clock::now() < until;) {
+            std::this_thread::sleep_for(10ms);
+        }
+        return pred();
+    };
+
+    write(opts.dump());
+    {
+        option_file_watcher watcher{pl, path, {}, std::chrono::milliseconds{20}};
+
+        opts["___pipes"]["second"]["watch.limit"] = 6;
+        write(opts.dump());
+        CHECK(wait_for([&] { return watcher.num_applied() > 0; }));
+        CHECK(exec_watched::limit(first.options()) == 5);
+        CHECK(exec_watched::limit(second.options()) == 6);
+
+        write("{ not a json");
+        CHECK(wait_for([&] { return watcher.num_rejected() > 0; }));
+        CHECK(exec_watched::limit(second.options()) == 6);
+        CHECK_FALSE(watcher.last_error().empty());
+
+        run_fence(pl, 8);
+        CHECK(output == 5);
+    }
+    std::filesystem::remove(path);
+
+    // 콜백은 잠금 밖에서 호출되므로, 콜백 안에서 감시자의 상태를 조회할 수 있습니다.
+    {
+        option_file_watcher* self = nullptr;
+        std::string seen;
+        option_file_watcher watcher{pl, path, [&](bool, std::string_view) { seen = self->last_error(); }};
+        self = &watcher;
+
+        CHECK_FALSE(watcher.reload());
+        CHECK(seen.find("cannot open") != std::string::npos);
+    }
+}
+
+struct exec_gated {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_gated);
+    PIPEPP_OPTION_FULL(int, limit, 1, "gate", "", verify::clamp(0, 10));
+
+    using input_type = int;
+    using output_type = int;
+
+    static inline std::atomic_bool entered = false;
+    static inline std::atomic_bool released = true;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        entered = true;
+        while (!released) { std::this_thread::yield(); }
+        return o = std::min(i, limit(ec)), pipe_error::ok;
+    }
+};
+
+TEST_CASE("option swap during fence", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_gated>;
+    auto pl = pipeline_type::make("first", 1, &make_executor<exec_gated>);
+    auto second = pl->front().create_and_link_output("second", 1, link_as_is, &make_executor<exec_gated>);
+    std::vector<std::pair<size_t, int>> outputs;
+    second.add_output_handler([&](my_shared_data const& sd, int const& o) { outputs.emplace_back(sd.option_generation(), o); });
+    pl->launch();
+
+    // 첫 파이프가 fence를 처리하는 도중 옵션을 교체해도, 그 fence의 두 번째 파이프는 교체 전 옵션을 사용합니다.
+    exec_gated::entered = false;
+    exec_gated::released = false;
+    suply_blocking(pl, 8);
+    while (!exec_gated::entered) { std::this_thread::yield(); }
+
+    nlohmann::json opts;
+    pl->export_options(opts);
+    opts["___pipes"]["first"]["gate.limit"] = 3;
+    opts["___pipes"]["second"]["gate.limit"] = 3;
+    opts["___suspended"] = nlohmann::json::array();
+    CHECK(pl->swap_options(opts));
+    auto generation = detail::option_base::latest_generation();
+
+    exec_gated::released = true;
+    pl->sync();
+    run_fence(pl, 8);
+
+    REQUIRE(outputs.size() == 2);
+    CHECK(outputs[0].first < generation);
+    CHECK(outputs[0].second == 1);
+    CHECK(outputs[1].first == generation);
+    CHECK(outputs[1].second == 3);
+}
+
+TEST_CASE("binary option export", "")
+{
+    using pipeline_type = pipeline<my_shared_data, exec_watched>;
+    auto make = [] {
+        auto pl = pipeline_type::make("first", 1, &make_executor<exec_watched>);
+        pl->front().create_and_link_output("second", 1, link_as_is, &make_executor<exec_watched>);
+        return pl;
+    };
+
+    auto src = make();
+    auto first = src->front();
+    auto second = *src->get_pipe("second");
+    exec_watched::limit(first.options(), 7);
+
+    for (auto format : {option_format::json, option_format::cbor, option_format::msgpack}) {
+        auto dst = make();
+        dst->import_options(src->export_options(format), format);
+        CHECK(exec_watched::limit(dst->front().options()) == 7);
+        CHECK(exec_watched::limit(dst->get_pipe("second")->options()) == 1);
+    }
+    CHECK(src->export_options(option_format::cbor).size() < src->export_options(option_format::json).size());
+
+    // 변경분 내보내기는 주어진 세대 이후 바뀐 옵션만 담습니다.
+    nlohmann::json diff;
+    src->export_options(diff, 0);
+    CHECK(diff["___pipes"].size() == 2);
+    auto generation = diff["___generation"].get<size_t>();
+
+    src->export_options(diff, generation);
+    CHECK(diff["___shared"].empty());
+    CHECK(diff["___pipes"].empty());
+
+    exec_watched::limit(second.options(), 2);
+    src->export_options(diff, generation);
+    REQUIRE(diff["___pipes"].size() == 1);
+    CHECK(diff["___pipes"]["second"] == nlohmann::json{{"watch.limit", 2}});
+    CHECK(diff["___generation"].get<size_t>() > generation);
+
+    // mark_modified() 없이 직접 수정한 값도 검출합니다.
+    generation = diff["___generation"].get<size_t>();
+    second.options().value()["watch.limit"] = 3;
+    src->export_options(diff, generation);
+    CHECK(diff["___pipes"]["second"] == nlohmann::json{{"watch.limit", 3}});
+
+    auto dst = make();
+    dst->import_options(nlohmann::json::to_msgpack(diff), option_format::msgpack);
+    CHECK(exec_watched::limit(dst->front().options()) == 1);
+    CHECK(exec_watched::limit(dst->get_pipe("second")->options()) == 3);
+}
+
+struct exec_blob {
+    PIPEPP_DECLARE_OPTION_CLASS(exec_blob);
+    PIPEPP_OPTION_FULL(option_blob<int>, table, (option_blob<int>{1, 2, 3}), "blob");
+
+    using input_type = int;
+    using output_type = int const*;
+
+    pipe_error invoke(execution_context& ec, input_type const& i, output_type& o)
+    {
+        auto values = table(ec);
+        return o = values.data(), values.size() > size_t(i) ? pipe_error::ok : pipe_error::error;
+    }
+};
+
+TEST_CASE("blob options", "")
+{
+    auto pl = pipeline<my_shared_data, exec_blob>::make("blob", 1, &make_executor<exec_blob>);
+    auto proxy = pl->front();
+    std::vector<int const*> outputs;
+    proxy.add_output_handler([&](my_shared_data const&, int const* const& o) { outputs.push_back(o); });
+    pl->launch();
+
+    auto run = [&] {
+        run_fence(pl, 0);
+    };
+
+    // 같은 세대에서는 스냅샷이 보관한 정렬된 메모리를 복사 없이 그대로 읽습니다.
+    run(), run();
+    REQUIRE(outputs.size() == 2);
+    CHECK(outputs[0] == outputs[1]);
+    CHECK(reinterpret_cast<uintptr_t>(outputs[0]) % option_blob<int>::alignment == 0);
+
+    std::vector<int> lut(1024);
+    std::iota(lut.begin(), lut.end(), 0);
+    option_blob<int> blob{lut};
+    exec_blob::table(proxy.options(), blob);
+    CHECK(std::ranges::equal(exec_blob::table(proxy.options()), lut));
+
+    // 옵션 json에는 핸들만 저장되며, 읽을 때는 기록한 버퍼를 복사 없이 공유합니다.
+    auto& stored = proxy.options().value()["blob.table"];
+    CHECK(detail::is_blob_handle(stored));
+    CHECK(stored.dump().size() < 64);
+    CHECK(exec_blob::table(proxy.options()).data() == blob.data());
+    run();
+    CHECK(outputs.back() == blob.data());
+
+    // 내보낸 문서에서 바이트열은 옵션 값과 분리된 ___blobs 섹션에 담기며, 바이너리 형식에서는 하나의 바이트열로 직렬화됩니다.
+    nlohmann::json exported;
+    pl->export_options(exported);
+    CHECK(detail::is_blob_handle(exported["___pipes"]["blob"]["blob.table"]));
+    CHECK(exported["___blobs"][std::to_string(blob.handle())].get_binary().size() == lut.size() * sizeof(int));
+
+    auto cbor = pl->export_options(option_format::cbor);
+    CHECK(cbor.size() < lut.size() * sizeof(int) + 256);
+
+    auto other = pipeline<my_shared_data, exec_blob>::make("blob", 1, &make_executor<exec_blob>);
+    other->import_options(cbor, option_format::cbor);
+    CHECK(detail::is_blob_handle(other->front().options().value()["blob.table"]));
+    CHECK(std::ranges::equal(exec_blob::table(other->front().options()), lut));
+    CHECK(exec_blob::table(other->front().options()).data() != blob.data());
+
+    // json 텍스트로 내보낸 ___blobs 섹션도 다시 핸들로 연결됩니다.
+    auto text = pl->export_options(option_format::json);
+    auto from_text = pipeline<my_shared_data, exec_blob>::make("blob", 1, &make_executor<exec_blob>);
+    from_text->import_options(text, option_format::json);
+    CHECK(detail::is_blob_handle(from_text->front().options().value()["blob.table"]));
+    CHECK(std::ranges::equal(exec_blob::table(from_text->front().options()), lut));
+
+    // 설정 파일 감시기가 사용하는 swap_options() 경로도 같습니다.
+    auto swapped = pipeline<my_shared_data, exec_blob>::make("blob", 1, &make_executor<exec_blob>);
+    CHECK(swapped->swap_options(nlohmann::json::parse(text.begin(), text.end())));
+    CHECK(std::ranges::equal(exec_blob::table(swapped->front().options()), lut));
+
+    // 더 이상 어떤 옵션도 참조하지 않는 blob은 해제되며, 만료된 핸들은 검증 실패로 보고됩니다.
+    auto handle = blob.handle();
+    blob = {};
+    exec_blob::table(proxy.options(), option_blob<int>{7});
+    run();
+    CHECK(detail::find_blob(handle).data == nullptr);
+
+    std::string error;
+    exported["___blobs"] = nlohmann::json::object();
+    CHECK_FALSE(other->swap_options(exported, &error));
+    CHECK(error.find("expired") != std::string::npos);
+    CHECK(std::ranges::equal(exec_blob::table(other->front().options()), lut));
+
+    // 직접 작성한 설정 파일의 원소별 배열도 불러올 수 있습니다.
+    nlohmann::json opts;
+    other->export_options(opts);
+    opts["___pipes"]["blob"]["blob.table"] = {4, 5};
+    other->import_options(opts);
+    CHECK(std::ranges::equal(exec_blob::table(other->front().options()), std::vector{4, 5}));
+}
 } // namespace pipepp_test::pipelines